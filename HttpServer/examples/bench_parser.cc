@@ -0,0 +1,94 @@
+// 请求解析的微基准：统计解析一个典型浏览器请求所需的堆分配次数和耗时
+// 编译：g++ -O2 -std=c++20 -I../include bench_parser.cc ../src/http/HttpContext.cpp
+//       ../src/http/HttpRequest.cpp ../src/http/HeaderScanner.cpp ../src/http/HttpHeaders.cpp ../src/http/Cookies.cpp -lmuduo_net -lmuduo_base -lpthread -o bench_parser
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <muduo/net/Buffer.h>
+
+#include "http/HttpContext.h"
+
+static size_t g_allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+static const char kRequest[] =
+    "POST /aiBot/move HTTP/1.1\r\n"
+    "Host: gomoku.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 15\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"122\", \"Not(A:Brand\";v=\"24\"\r\n"
+    "Content-Type: application/json\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/122.0.0.0 Safari/537.36\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Accept: */*\r\n"
+    "Origin: https://gomoku.example.com\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: cors\r\n"
+    "Sec-Fetch-Dest: empty\r\n"
+    "Referer: https://gomoku.example.com/aiBot/start\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Cookie: sessionId=0123456789abcdef0123456789abcdef\r\n"
+    "\r\n"
+    "{\"x\":7,\"y\":8}  ";
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const size_t requestLen = sizeof(kRequest) - 1;
+
+    http::HttpContext context;
+    muduo::net::Buffer buf;
+
+    // 预热：让 Buffer 和 HttpContext 内部容器达到稳定容量
+    buf.append(kRequest, requestLen);
+    context.parseRequest(&buf, muduo::Timestamp());
+    buf.retrieve(context.requestBytes());
+    context.reset();
+
+    size_t bodyBytes = 0;
+    size_t allocationsBefore = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        buf.append(kRequest, requestLen);
+        if (!context.parseRequest(&buf, muduo::Timestamp()) || !context.gotAll())
+        {
+            std::cerr << "parse failed" << std::endl;
+            return 1;
+        }
+        bodyBytes += context.request().body().size();
+        buf.retrieve(context.requestBytes());
+        context.reset();
+    }
+    auto end = std::chrono::steady_clock::now();
+    size_t allocations = g_allocations - allocationsBefore;
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "requests:              " << iterations << "\n"
+              << "allocations/request:   " << static_cast<double>(allocations) / iterations << "\n"
+              << "ns/request:            " << ns / iterations << "\n"
+              << "body bytes:            " << bodyBytes << std::endl;
+    return 0;
+}
@@ -0,0 +1,132 @@
+// 流水线请求的基准：客户端在一个连接上一次发出 depth 个请求再读回全部响应，
+// 统计吞吐量以及服务端每个请求调用了多少次 write(2)（同一次 onMessage 的响应合并写出后应接近 1 / depth）
+// 编译：g++ -O2 -std=c++20 -I../include bench_pipeline.cc ../src/http/*.cpp ../src/router/*.cpp
+//       ../src/session/*.cpp ../src/middleware/*.cpp ../src/middleware/*/*.cpp ../src/ssl/*.cpp
+//       ../src/utils/CompressUtil.cpp ../src/utils/WorkerPool.cpp
+//       -lmuduo_net -lmuduo_base -lssl -lcrypto -lz -lbrotlienc -lpthread -o bench_pipeline
+// 运行：./bench_pipeline [depth] [rounds]
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <muduo/base/Logging.h>
+
+#include "http/HttpServer.h"
+
+namespace
+{
+
+std::atomic<long> socketWrites(0);
+
+const int kPort = 18080;
+
+} // namespace
+
+// 覆盖 libc 的 write，统计 muduo 写套接字的次数（标准输出、标准错误不计）
+extern "C" ssize_t write(int fd, const void* buf, size_t count)
+{
+    if (fd > 2)
+    {
+        socketWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+    return syscall(SYS_write, fd, buf, count);
+}
+
+// 读回 n 个响应（按 Content-Length 跳过响应体）
+bool readResponses(int fd, int n, std::string* pending)
+{
+    char buf[65536];
+    while (n > 0)
+    {
+        size_t headEnd = pending->find("\r\n\r\n");
+        if (headEnd != std::string::npos)
+        {
+            size_t pos = pending->find("Content-Length: ");
+            size_t length = pos < headEnd ? std::strtoul(pending->c_str() + pos + 16, nullptr, 10) : 0;
+            size_t total = headEnd + 4 + length;
+            if (pending->size() >= total)
+            {
+                pending->erase(0, total);
+                --n;
+                continue;
+            }
+        }
+        ssize_t r = ::read(fd, buf, sizeof buf);
+        if (r <= 0)
+        {
+            return false;
+        }
+        pending->append(buf, r);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const int depth = argc > 1 ? std::atoi(argv[1]) : 16;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 20000;
+    muduo::Logger::setLogLevel(muduo::Logger::WARN);
+
+    // EventLoop 必须在运行它的线程中创建
+    std::thread serverThread([]() {
+        http::HttpServer server(kPort, "bench_pipeline");
+        server.Get("/ping", [](const http::HttpRequest&, http::HttpResponse* resp) {
+            resp->setStatusLine("HTTP/1.1", http::HttpResponse::k200Ok, "OK");
+            resp->setCloseConnection(false);
+            resp->setContentType("text/plain");
+            resp->setBody("pong");
+        });
+        server.start();
+    });
+    serverThread.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof addr) != 0)
+    {
+        std::cerr << "connect failed" << std::endl;
+        return 1;
+    }
+
+    std::string batch;
+    for (int i = 0; i < depth; ++i)
+    {
+        batch += "GET /ping HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+
+    std::string pending;
+    long writesBefore = socketWrites.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+    {
+        if (::send(fd, batch.data(), batch.size(), 0) != static_cast<ssize_t>(batch.size()) ||
+            !readResponses(fd, depth, &pending))
+        {
+            std::cerr << "connection broken" << std::endl;
+            return 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long requests = static_cast<long>(depth) * rounds;
+    long writes = socketWrites.load() - writesBefore;
+
+    std::cout << "depth=" << depth << " requests=" << requests
+              << " req/s=" << static_cast<long>(requests / seconds)
+              << " server writes/request=" << static_cast<double>(writes) / requests << std::endl;
+    ::close(fd);
+    _exit(0);
+}
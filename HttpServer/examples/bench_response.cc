@@ -0,0 +1,43 @@
+// 响应序列化的微基准：统计一个典型的 200 JSON 响应每秒能序列化多少次
+// 编译：g++ -O2 -std=c++20 -I../include bench_response.cc ../src/http/HttpResponse.cpp
+//       ../src/http/HttpDate.cpp ../src/http/HttpHeaders.cpp -lmuduo_net -lmuduo_base -lpthread -o bench_response
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <muduo/net/Buffer.h>
+
+#include "http/HttpResponse.h"
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const std::string body = "{\"status\":\"success\",\"move\":{\"x\":7,\"y\":8},\"winner\":\"none\"}";
+
+    muduo::net::Buffer buf;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        // 与 AiGameMoveHandler 的写法一致
+        http::HttpResponse resp(false);
+        resp.setStatusLine("HTTP/1.1", http::HttpResponse::k200Ok, "OK");
+        resp.setCloseConnection(false);
+        resp.setContentType("application/json");
+        resp.setContentLength(body.size());
+        resp.setBody(body);
+        resp.appendToBuffer(&buf);
+
+        bytes += buf.readableBytes();
+        buf.retrieveAll();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "responses:             " << iterations << "\n"
+              << "responses/sec:         " << static_cast<uint64_t>(iterations / seconds) << "\n"
+              << "ns/response:           " << seconds * 1e9 / iterations << "\n"
+              << "bytes/response:        " << bytes / iterations << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+// 路由匹配的微基准：分别注册 10 / 100 / 1000 条路由（静态路径、带一个参数、带两个参数各占三分之一），
+// 轮流查找能匹配到每条路由的路径，统计每次匹配的耗时；
+// 再用 10 条静态路径对比动态路由和编译期静态路由表（StaticRouter）
+// 编译：g++ -O2 -std=c++20 -I../include bench_router.cc ../src/router/Router.cpp ../src/router/RadixTree.cpp
+//       ../src/http/HttpRequest.cpp ../src/http/HttpResponse.cpp ../src/http/HttpHeaders.cpp ../src/http/HttpDate.cpp
+//       ../src/http/FileBody.cpp -lmuduo_net -lmuduo_base -lpthread -o bench_router
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "router/Router.h"
+#include "router/StaticRouter.h"
+
+namespace
+{
+
+void run(int routeCount, int iterations)
+{
+    http::router::Router router;
+    std::vector<std::string> paths;
+    int hits = 0;
+    auto callback = [&hits](const http::HttpRequest&, http::HttpResponse*) { ++hits; };
+
+    for (int i = 0; i < routeCount; ++i)
+    {
+        std::string resource = "/api/v1/resource" + std::to_string(i / 3);
+        switch (i % 3)
+        {
+        case 0:
+            router.registerCallback(http::HttpRequest::kGet, resource, callback);
+            paths.push_back(resource);
+            break;
+        case 1:
+            router.registerCallback(http::HttpRequest::kGet, resource + "/:id", callback);
+            paths.push_back(resource + "/12345");
+            break;
+        default:
+            router.registerCallback(http::HttpRequest::kGet, resource + "/:id/items/:item", callback);
+            paths.push_back(resource + "/12345/items/678");
+            break;
+        }
+    }
+
+    std::vector<http::HttpRequest> requests(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        const char* method = "GET";
+        requests[i].setMethod(method, method + 3);
+        requests[i].setPath(paths[i].data(), paths[i].data() + paths[i].size());
+    }
+
+    http::HttpResponse resp;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        router.route(requests[i % requests.size()], &resp);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << routeCount << " routes: " << ns / iterations << " ns/match"
+              << (hits == iterations ? "" : " (MISSED)") << std::endl;
+}
+
+template <typename Route>
+double measure(Route&& route, const std::vector<http::HttpRequest>& requests, int iterations)
+{
+    http::HttpResponse resp;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        route(const_cast<http::HttpRequest&>(requests[i % requests.size()]), &resp);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+void runStatic(int iterations)
+{
+    using http::router::get;
+    using http::router::post;
+
+    int hits = 0;
+    auto callback = [&hits](const http::HttpRequest&, http::HttpResponse*) { ++hits; };
+    auto staticRouter = http::router::makeStaticRouter(
+        get<"/">(callback), get<"/entry">(callback), post<"/login">(callback), post<"/register">(callback),
+        post<"/user/logout">(callback), get<"/menu">(callback), get<"/aiBot/start">(callback),
+        post<"/aiBot/move">(callback), get<"/aiBot/restart">(callback), get<"/backend">(callback));
+
+    http::router::Router router;
+    std::vector<http::HttpRequest> requests;
+    for (const char* line : { "GET /", "GET /entry", "POST /login", "POST /register", "POST /user/logout",
+                              "GET /menu", "GET /aiBot/start", "POST /aiBot/move", "GET /aiBot/restart",
+                              "GET /backend" })
+    {
+        std::string_view text(line);
+        size_t space = text.find(' ');
+        http::HttpRequest req;
+        req.setMethod(text.data(), text.data() + space);
+        req.setPath(text.data() + space + 1, text.data() + text.size());
+        router.registerCallback(req.method(), std::string(req.pathView()), callback);
+        requests.push_back(std::move(req));
+    }
+
+    double dynamicNs = measure([&router](http::HttpRequest& req, http::HttpResponse* resp) {
+        router.route(req, resp);
+    }, requests, iterations);
+    double staticNs = measure([&staticRouter](http::HttpRequest& req, http::HttpResponse* resp) {
+        staticRouter.route(req, resp);
+    }, requests, iterations);
+
+    std::cout << "10 static paths: Router " << dynamicNs << " ns/match, StaticRouter " << staticNs << " ns/match"
+              << (hits == 2 * iterations ? "" : " (MISSED)") << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    for (int routeCount : { 10, 100, 1000 })
+    {
+        run(routeCount, iterations);
+    }
+    runStatic(iterations);
+}
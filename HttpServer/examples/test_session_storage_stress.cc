@@ -0,0 +1,163 @@
+// 会话存储的并发压力测试，配合 ThreadSanitizer 使用：模拟多个 IO 线程读写会话，同时主线程的定时器
+// 每隔几毫秒调用一次 removeExpired（HttpServer::start 中的 runEvery 每秒一次）。
+// 会话的有效期只有 1 秒，运行期间会反复发生过期淘汰、刷新后重新挂定时器、过期后重新创建。
+// 依次测试 MemorySessionStorage、ShardedSessionStorage 和 MmapSessionStorage，
+// 共享的会话同时被多个线程修改和提交；检查 load 返回的会话 id 正确且没有过期，
+// TSan 报告数据竞争时进程以非 0 退出码结束
+// 编译：g++ -O1 -g -std=c++20 -fsanitize=thread -I../include test_session_storage_stress.cc
+//       ../src/session/SessionStorage.cpp ../src/session/ShardedSessionStorage.cpp
+//       ../src/session/MmapSessionStorage.cpp ../src/session/Session.cpp ../src/session/SessionManager.cpp
+//       ../src/http/HttpRequest.cpp ../src/http/HttpResponse.cpp ../src/http/HttpHeaders.cpp
+//       ../src/http/HttpDate.cpp ../src/http/FileBody.cpp
+//       -lmuduo_net -lmuduo_base -lpthread -lz -o test_session_storage_stress
+// 运行：./test_session_storage_stress [写线程数] [秒数]
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "session/MmapSessionStorage.h"
+#include "session/SessionStorage.h"
+#include "session/ShardedSessionStorage.h"
+
+namespace
+{
+
+using http::session::Session;
+using http::session::SessionStorage;
+
+const int kSessionsPerThread = 512;
+// 一半的会话由所有线程共享，另一半各线程独占
+const int kSharedSessions = 256;
+
+std::string sessionIdFor(int owner, int index)
+{
+    return "s-" + std::to_string(owner) + "-" + std::to_string(index);
+}
+
+// 返回发现的错误数
+int run(const char* name, SessionStorage& storage, int threads, double seconds)
+{
+    std::atomic<bool> stop{ false };
+    std::atomic<int>  errors{ 0 };
+    std::atomic<long> operations{ 0 };
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+    {
+        writers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            long count = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                bool shared = rng() % 2 == 0;
+                std::string sessionId = shared ? sessionIdFor(-1, rng() % kSharedSessions)
+                                               : sessionIdFor(t, rng() % kSessionsPerThread);
+                // 按请求的处理顺序：加载会话，不存在就新建，修改或只刷新过期时间，请求结束时保存
+                std::shared_ptr<Session> session = storage.load(sessionId);
+                if (session)
+                {
+                    if (session->getId() != sessionId || session->isExpired())
+                    {
+                        ++errors;
+                    }
+                }
+                else
+                {
+                    session = std::make_shared<Session>(sessionId, nullptr, 1);
+                }
+                switch (rng() % 8)
+                {
+                case 0:
+                    storage.remove(sessionId);
+                    break;
+                case 1:
+                case 2:
+                    session->refresh();
+                    if (!storage.touch(session))
+                    {
+                        storage.save(session);
+                    }
+                    break;
+                default:
+                    // 共享的会话对象同时被多个线程修改、提交（Session 内部加锁）
+                    session->setValue("n", std::to_string(count));
+                    session->setValue("t" + std::to_string(t), std::to_string(count));
+                    if (!session->takeDirtyKeys().empty())
+                    {
+                        storage.save(session);
+                    }
+                    break;
+                }
+                ++count;
+            }
+            operations += count;
+        });
+    }
+
+    // 主线程的定时器
+    std::thread cleaner([&] {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            storage.removeExpired();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    cleaner.join();
+
+    std::cout << name << ": " << operations.load() << " operations, " << errors.load() << " errors" << std::endl;
+    return errors.load();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 3;
+    int errors = 0;
+
+    {
+        http::session::MemorySessionStorage storage;
+        errors += run("MemorySessionStorage", storage, threads, seconds);
+    }
+    {
+        http::session::ShardedSessionStorage storage;
+        errors += run("ShardedSessionStorage", storage, threads, seconds);
+        auto stats = storage.stats();
+        std::cout << "  sessions=" << stats.sessions << " evictions=" << stats.evictions
+                  << " contended=" << stats.contended << "/" << stats.acquisitions << std::endl;
+    }
+    {
+        std::string path = "/tmp/test_session_storage_stress.dat";
+        ::unlink(path.c_str());
+        http::session::MmapSessionStorage storage(path, 256, 64);
+        errors += run("MmapSessionStorage", storage, threads, seconds);
+        auto stats = storage.stats();
+        std::cout << "  sessions=" << stats.sessions << " slots=" << stats.slots
+                  << " freeSlots=" << stats.freeSlots << std::endl;
+        ::unlink(path.c_str());
+    }
+
+    if (errors != 0)
+    {
+        std::cerr << errors << " errors" << std::endl;
+        return 1;
+    }
+    std::cout << "all passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,193 @@
+// TimingWheel 的正确性测试：固定用例覆盖同一刻度、已经过去的刻度、跨层下放、超出表示范围的到期时间，
+// 再用随机的插入、推进序列和逐项比较的朴素实现对拍。全部通过时输出 "all passed"，退出码为 0
+// 编译：g++ -O2 -std=c++20 -I../include test_timing_wheel.cc -o test_timing_wheel
+// 运行：./test_timing_wheel [随机轮数]
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "utils/TimingWheel.h"
+
+namespace
+{
+
+int failures = 0;
+
+#define CHECK(cond)                                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            ++failures;                                                                 \
+        }                                                                               \
+    } while (0)
+
+struct Fired
+{
+    int     value;
+    int64_t deadline;
+    int64_t tick;
+};
+
+// 推进到 now，记录每一项在哪个刻度到期
+std::vector<Fired> advanceTo(http::TimingWheel<int>& wheel, int64_t now)
+{
+    std::vector<Fired> fired;
+    while (wheel.current() < now)
+    {
+        wheel.advance(wheel.current() + 1, [&](int value, int64_t deadline) {
+            fired.push_back(Fired{ value, deadline, wheel.current() });
+        });
+    }
+    return fired;
+}
+
+void testSameTick()
+{
+    http::TimingWheel<int> wheel(100);
+    wheel.schedule(105, 1);
+    wheel.schedule(105, 2);
+    wheel.schedule(106, 3);
+    CHECK(wheel.size() == 3);
+    CHECK(advanceTo(wheel, 104).empty());
+    auto fired = advanceTo(wheel, 105);
+    CHECK(fired.size() == 2);
+    for (const Fired& f : fired)
+    {
+        CHECK(f.tick == 105 && f.deadline == 105);
+    }
+    fired = advanceTo(wheel, 106);
+    CHECK(fired.size() == 1 && fired[0].value == 3);
+    CHECK(wheel.size() == 0);
+}
+
+void testPastDeadline()
+{
+    http::TimingWheel<int> wheel(1000);
+    wheel.schedule(10, 1);
+    wheel.schedule(1000, 2);
+    auto fired = advanceTo(wheel, 1001);
+    CHECK(fired.size() == 2);
+    for (const Fired& f : fired)
+    {
+        CHECK(f.tick == 1001);
+    }
+}
+
+// 到期时间落在第 1、2、3 层，逐层下放后必须在准确的刻度到期
+void testCascade()
+{
+    const int64_t deadlines[] = { 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145, 1000000 };
+    http::TimingWheel<int> wheel(0);
+    for (int64_t deadline : deadlines)
+    {
+        wheel.schedule(deadline, static_cast<int>(deadline));
+    }
+    auto fired = advanceTo(wheel, 1000000);
+    CHECK(fired.size() == std::size(deadlines));
+    for (const Fired& f : fired)
+    {
+        CHECK(f.tick == f.deadline);
+    }
+}
+
+// 起点不在整圈上时，高层槽的下放边界也要正确
+void testUnalignedStart()
+{
+    http::TimingWheel<int> wheel(4000);
+    wheel.schedule(4096, 1);
+    wheel.schedule(4100, 2);
+    wheel.schedule(8191, 3);
+    wheel.schedule(8192, 4);
+    auto fired = advanceTo(wheel, 9000);
+    CHECK(fired.size() == 4);
+    for (const Fired& f : fired)
+    {
+        CHECK(f.tick == f.deadline);
+    }
+}
+
+// 超出 64^4 个刻度的项先挂在最高层，转到时重新放置，最终在准确的刻度到期
+void testBeyondRange()
+{
+    const int64_t range = int64_t(1) << 24;
+    http::TimingWheel<int> wheel(0);
+    wheel.schedule(range + 10, 1);
+    int64_t firedAt = -1;
+    int64_t now = 0;
+    while (firedAt < 0 && now < 3 * range)
+    {
+        now += 4096;
+        wheel.advance(now, [&](int, int64_t deadline) { firedAt = deadline; });
+    }
+    CHECK(firedAt == range + 10);
+    CHECK(wheel.size() == 0);
+}
+
+// 随机插入和推进，与按到期时间排序的 multimap 对拍：每一项都在 max(deadline, 插入后的下一刻度) 到期
+void testRandom(int rounds)
+{
+    std::mt19937_64 rng(20240601);
+    for (int round = 0; round < rounds; ++round)
+    {
+        int64_t start = static_cast<int64_t>(rng() % 1000000);
+        http::TimingWheel<int> wheel(start);
+        std::multimap<int64_t, int> expected;
+        int next = 0;
+        for (int step = 0; step < 200; ++step)
+        {
+            int inserts = static_cast<int>(rng() % 8);
+            for (int i = 0; i < inserts; ++i)
+            {
+                // 大多数到期时间在几分钟内，少数跨越高层
+                int64_t delta = rng() % 4 == 0 ? static_cast<int64_t>(rng() % 300000) : static_cast<int64_t>(rng() % 200);
+                int64_t deadline = wheel.current() + delta - 5;
+                wheel.schedule(deadline, next);
+                expected.emplace(std::max(deadline, wheel.current() + 1), next);
+                ++next;
+            }
+            int64_t target = wheel.current() + static_cast<int64_t>(rng() % (rng() % 10 == 0 ? 5000 : 50));
+            for (const Fired& f : advanceTo(wheel, target))
+            {
+                auto range = expected.equal_range(f.tick);
+                bool found = false;
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    if (it->second == f.value)
+                    {
+                        expected.erase(it);
+                        found = true;
+                        break;
+                    }
+                }
+                CHECK(found);
+            }
+            CHECK(expected.empty() || expected.begin()->first > wheel.current());
+            CHECK(wheel.size() == expected.size());
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    testSameTick();
+    testPastDeadline();
+    testCascade();
+    testUnalignedStart();
+    testBeyondRange();
+    testRandom(rounds);
+    if (failures != 0)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all passed" << std::endl;
+    return 0;
+}
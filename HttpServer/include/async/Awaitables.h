@@ -0,0 +1,156 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <muduo/net/EventLoop.h>
+
+#include "../utils/WorkerPool.h"
+
+namespace http
+{
+namespace async
+{
+
+// 工作线程池排队已满，co_await runInPool(...) 时抛出（HttpServer 返回 503）
+class WorkerPoolFull : public std::runtime_error
+{
+public:
+    WorkerPoolFull()
+        : std::runtime_error("worker pool is full")
+    {}
+};
+
+// 在工作线程池中执行 fn，完成后回到挂起时所在的 EventLoop 恢复协程，co_await 的结果就是 fn 的返回值。
+// 协程在 IO 线程中挂起时就回到该连接所属的 IO 线程；pool 为空时直接在当前线程执行
+template <typename F>
+class PoolAwaitable
+{
+public:
+    using Result = std::invoke_result_t<F&>;
+
+    PoolAwaitable(WorkerPool* pool, F fn)
+        : pool_(pool)
+        , fn_(std::move(fn))
+    {}
+
+    bool await_ready() const noexcept
+    { return pool_ == nullptr; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        muduo::net::EventLoop* loop = muduo::net::EventLoop::getEventLoopOfCurrentThread();
+        bool posted = pool_->post([this, handle, loop]() {
+            invoke();
+            if (loop)
+            {
+                loop->runInLoop([handle]() { handle.resume(); });
+            }
+            else
+            {
+                handle.resume();
+            }
+        });
+        if (!posted)
+        {
+            rejected_ = true;
+            // 不挂起，await_resume 抛出 WorkerPoolFull
+            return false;
+        }
+        return true;
+    }
+
+    Result await_resume()
+    {
+        if (rejected_)
+        {
+            throw WorkerPoolFull();
+        }
+        if (pool_ == nullptr)
+        {
+            invoke();
+        }
+        if (exception_)
+        {
+            std::rethrow_exception(exception_);
+        }
+        if constexpr (!std::is_void_v<Result>)
+        {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    void invoke()
+    {
+        try
+        {
+            if constexpr (std::is_void_v<Result>)
+            {
+                fn_();
+            }
+            else
+            {
+                result_.emplace(fn_());
+            }
+        }
+        catch (...)
+        {
+            exception_ = std::current_exception();
+        }
+    }
+
+    using Storage = std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>>;
+
+    WorkerPool*        pool_;
+    F                  fn_;
+    Storage            result_ {};
+    std::exception_ptr exception_;
+    bool               rejected_ { false };
+};
+
+template <typename F>
+PoolAwaitable<F> runInPool(WorkerPool* pool, F fn)
+{
+    return PoolAwaitable<F>(pool, std::move(fn));
+}
+
+// 挂起协程 seconds 秒，由当前 EventLoop 的定时器恢复，不占用线程
+class SleepAwaitable
+{
+public:
+    explicit SleepAwaitable(double seconds)
+        : seconds_(seconds)
+    {}
+
+    bool await_ready() const noexcept
+    { return seconds_ <= 0; }
+
+    bool await_suspend(std::coroutine_handle<> handle) const
+    {
+        muduo::net::EventLoop* loop = muduo::net::EventLoop::getEventLoopOfCurrentThread();
+        if (loop == nullptr)
+        {
+            throw std::logic_error("sleepFor must be awaited in an EventLoop thread");
+        }
+        loop->runAfter(seconds_, [handle]() { handle.resume(); });
+        return true;
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    double seconds_;
+};
+
+inline SleepAwaitable sleepFor(double seconds)
+{
+    return SleepAwaitable(seconds);
+}
+
+} // namespace async
+} // namespace http
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+namespace async
+{
+
+template <typename T = void>
+class Task;
+
+namespace detail
+{
+
+struct PromiseBase
+{
+    // 协程结束时恢复等待它的协程（对称转移，不增加调用栈深度）
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        { return handle.promise().continuation; }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr      exception;
+};
+
+} // namespace detail
+
+// 异步处理器的返回类型：惰性启动，被 co_await 时才开始执行，执行完后恢复等待者；
+// 协程中抛出的异常在 co_await 处重新抛出
+template <typename T>
+class Task
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        Task get_return_object()
+        { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        template <typename U>
+        void return_value(U&& value)
+        { result.emplace(std::forward<U>(value)); }
+
+        std::optional<T> result;
+    };
+
+    Task(Task&& that) noexcept
+        : handle_(std::exchange(that.handle_, nullptr))
+    {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        if (handle_.promise().exception)
+        {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+        return std::move(*handle_.promise().result);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+class Task<void>
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        Task get_return_object()
+        { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        void return_void() {}
+    };
+
+    Task(Task&& that) noexcept
+        : handle_(std::exchange(that.handle_, nullptr))
+    {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+
+    void await_resume()
+    {
+        if (handle_.promise().exception)
+        {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// 立即开始执行、结束时自行销毁的协程，用于在回调中启动一个 Task（HttpServer 驱动异步处理器）。
+// 协程体需要自己处理所有异常
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept
+        { LOG_ERROR << "unhandled exception in detached coroutine"; }
+    };
+};
+
+} // namespace async
+} // namespace http
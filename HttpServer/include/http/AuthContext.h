@@ -0,0 +1,22 @@
+#pragma once
+
+namespace http
+{
+
+// 本次请求的用户身份：由 AuthMiddleware 从会话中解析一次并挂到 HttpRequest 上，
+// 处理器直接读取类型化的字段，不再逐个比较会话中的字符串
+struct AuthContext
+{
+    enum Role
+    {
+        kGuest,
+        kUser,
+        kAdmin,
+    };
+
+    int  userId = -1;
+    bool loggedIn = false;
+    Role role = kGuest;
+};
+
+} // namespace http
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace http
+{
+
+// 请求 Cookie 头解析出的名字/值表：固定容量的内联数组，不分配内存，名字和值引用请求头中的数据。
+// 超出容量的部分不丢弃，保留未解析的剩余部分，get() 在内联数组中找不到时再扫描它
+class RequestCookies
+{
+public:
+    struct Cookie
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    static constexpr size_t kCapacity = 16;
+
+    // 解析 "name=value; name2=value2"，去掉值两边的双引号；超出容量的部分留到 get() 时再扫描
+    void parse(std::string_view header);
+
+    // 没有该 Cookie 时返回空；同名时取第一个（浏览器把路径更具体的放在前面）
+    std::string_view get(std::string_view name) const
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            if (cookies_[i].name == name)
+            {
+                return cookies_[i].value;
+            }
+        }
+        return rest_.empty() ? std::string_view() : findInRest(name);
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        rest_ = std::string_view();
+    }
+
+    // 内联数组中的 Cookie 数，begin()/end() 只遍历这一部分
+    size_t size() const
+    { return size_; }
+
+    // 超出容量、没有解析的剩余部分（同样引用请求头），请求数据移动位置时需要一起调整
+    std::string_view& remainder()
+    { return rest_; }
+
+    Cookie* begin() { return cookies_.data(); }
+    Cookie* end() { return cookies_.data() + size_; }
+    const Cookie* begin() const { return cookies_.data(); }
+    const Cookie* end() const { return cookies_.data() + size_; }
+
+private:
+    std::string_view findInRest(std::string_view name) const;
+
+private:
+    std::array<Cookie, kCapacity> cookies_;
+    size_t                        size_ { 0 };
+    std::string_view              rest_;
+};
+
+} // namespace http
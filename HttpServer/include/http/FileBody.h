@@ -0,0 +1,54 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+#include <muduo/base/noncopyable.h>
+
+namespace http
+{
+
+// 以文件作为响应体：持有打开的只读文件描述符，发送时按块读出，不把整个文件读进内存
+class FileBody : muduo::noncopyable
+{
+public:
+    // 打开文件失败（不存在、不是普通文件）时返回 nullptr
+    static std::shared_ptr<const FileBody> open(const std::string& path);
+
+    ~FileBody();
+
+    int fd() const { return fd_; }
+    size_t size() const { return size_; }
+    time_t lastModified() const { return mtime_; }
+    // 强 ETag："inode-大小-修改时间（纳秒）"，十六进制
+    const std::string& etag() const { return etag_; }
+    const std::string& path() const { return path_; }
+
+    // 从 offset 开始读取最多 len 字节，返回值与 pread(2) 相同
+    ssize_t read(off_t offset, char* buf, size_t len) const;
+
+    // 读取 [offset, offset + len) 到 out（TLS 连接整段加密发送）
+    bool readRange(size_t offset, size_t len, std::string* out) const;
+    bool readAll(std::string* out) const
+    { return readRange(0, size_, out); }
+
+private:
+    FileBody(int fd, size_t size, time_t mtime, const std::string& etag, const std::string& path)
+        : fd_(fd)
+        , size_(size)
+        , mtime_(mtime)
+        , etag_(etag)
+        , path_(path)
+    {}
+
+private:
+    int         fd_;
+    size_t      size_;
+    time_t      mtime_;
+    std::string etag_;
+    std::string path_;
+};
+
+} // namespace http
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+namespace http
+{
+
+// 请求头块扫描器：一次遍历找出所有行尾（\n）和每行第一个冒号，
+// 程序启动时根据 CPU 支持的指令集选择 AVX2 / SSE4.2 / 标量实现
+class HeaderScanner
+{
+public:
+    struct Line
+    {
+        const char* begin; // 行首
+        const char* colon; // 第一个 ':'，没有冒号时等于 end
+        const char* end;   // 行尾（指向 \r，没有 \r 时指向 \n）
+    };
+
+    // 从 begin 开始扫描完整的行，写入 lines（最多 maxLines 行），遇到空行（请求头结束）时停止。
+    // 返回扫描到的行数，*next 指向最后一个完整行之后的位置
+    static size_t scan(const char* begin, const char* end,
+                       Line* lines, size_t maxLines, const char** next)
+    {
+        return scanFunc_(begin, end, lines, maxLines, next);
+    }
+
+    // 当前使用的实现名称（"avx2" / "sse4.2" / "scalar"）
+    static const char* implementation();
+
+    using ScanFunc = size_t (*)(const char*, const char*, Line*, size_t, const char**);
+
+private:
+    static ScanFunc scanFunc_;
+};
+
+} // namespace http
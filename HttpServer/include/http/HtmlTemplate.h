@@ -0,0 +1,71 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "HttpResponse.h"
+
+namespace http
+{
+
+// 预编译的 HTML 模板：加载时把源文本切分成静态片段和 {{name}} 占位符，
+// 渲染时不再扫描或拷贝页面，响应体是 "静态片段 + 占位符的值" 组成的分段列表，
+// 静态片段直接引用模板源文本。占位符的值原样插入，需要转义时由调用方处理。
+// 分段响应体不能直接套用文件的预压缩版本，每次现场压缩又会抵消免拷贝渲染的收益：
+// 因此按占位符的取值缓存渲染结果的 gzip / brotli 版本（同一组取值只压缩一次），作为预压缩版本交给压缩阶段
+class HtmlTemplate : public std::enable_shared_from_this<HtmlTemplate>
+{
+public:
+    using Value = std::pair<std::string_view, std::string>; // 占位符名字 -> 值
+
+    static std::shared_ptr<const HtmlTemplate> compile(std::shared_ptr<const std::string> source);
+
+    // 占位符个数（同名占位符只算一个）
+    size_t slotCount() const
+    { return slotNames_.size(); }
+
+    // 渲染到响应体，没有给出值的占位符渲染为空
+    void render(std::initializer_list<Value> values, HttpResponse* resp) const;
+
+    // 渲染成一个完整的字符串
+    std::string renderToString(std::initializer_list<Value> values) const;
+
+private:
+    struct Part
+    {
+        std::string_view text; // 静态片段（slot < 0 时有效）
+        int              slot; // 占位符在 slotNames_ 中的下标，-1 表示静态片段
+    };
+
+    explicit HtmlTemplate(std::shared_ptr<const std::string> source)
+        : source_(std::move(source))
+    {}
+
+    struct Compressed
+    {
+        std::shared_ptr<const std::string> gzip; // 不值得压缩时为空
+        std::shared_ptr<const std::string> brotli;
+    };
+
+    static const size_t kMaxCompressedRenders = 1024; // 缓存满时整体清空
+    static const size_t kMinCompressSize = 256;
+
+    std::vector<std::string> resolve(std::initializer_list<Value> values) const;
+    std::string join(const std::vector<std::string>& resolved) const;
+    Compressed compressed(const std::vector<std::string>& resolved) const;
+
+private:
+    std::shared_ptr<const std::string> source_;
+    std::vector<Part>                  parts_;
+    std::vector<std::string_view>      slotNames_;
+    mutable std::mutex                 compressedMutex_;
+    mutable std::unordered_map<std::string, Compressed> compressed_; // 占位符取值（以 '\0' 连接） -> 压缩结果
+};
+
+} // namespace http
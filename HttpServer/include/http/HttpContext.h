@@ -1,9 +1,15 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <string_view>
 
 #include <muduo/net/TcpServer.h>
 
+#include "FileBody.h"
+#include "HeaderScanner.h"
 #include "HttpRequest.h"
 
 namespace http
@@ -17,13 +23,59 @@ public:
         kExpectRequestLine, // 解析请求行
         kExpectHeaders, // 解析请求头
         kExpectBody, // 解析请求体
+        kExpectChunkSize, // 解析分块长度行（Transfer-Encoding: chunked）
+        kExpectChunkData, // 解析分块数据
+        kExpectChunkEnd, // 解析分块数据后的 CRLF
+        kExpectTrailers, // 解析最后一个分块之后的尾部字段
         kGotAll, // 解析完成
     };
+
+    // parseRequest 返回 false 时的错误类型
+    enum ParseError
+    {
+        kNoError,
+        kBadRequest, // 语法错误或有歧义的报文（回复 400）
+        kPayloadTooLarge, // 整体缓存的请求体超过上限（回复 413）
+    };
+
+    // 整体缓存的请求体默认上限；流式接收的请求体不受限制（数据到达即交付，不占用内存）
+    static constexpr uint64_t kDefaultMaxBodySize = 8 * 1024 * 1024;
+
+    // 正在发送的文件响应
+    struct FileTransfer
+    {
+        std::shared_ptr<const FileBody> file;
+        off_t                           offset; // 下一个要发送的字节
+        off_t                           end; // 发送到这里为止（不含）
+        bool                            closeAfter; // 发送完成后关闭连接
+        muduo::net::Buffer              chunk; // 读出的文件块，发送后清空，容量复用
+    };
+
+    // 流式请求体回调：每收到一段请求体数据就调用一次，数据交付后立即从缓冲区中回收
+    using BodyCallback = std::function<void (const HttpRequest&, std::string_view)>;
+    // 请求头解析完成且后面还有请求体时调用，返回非空的 BodyCallback 表示以流式方式接收请求体。
+    // 请求可以修改（选择器会先执行前置中间件，设置请求的身份等）
+    using BodyStreamSelector = std::function<BodyCallback (HttpRequest&)>;
     
     HttpContext()
     : state_(kExpectRequestLine)
+    , parsedBytes_(0)
+    , base_(nullptr)
+    , chunked_(false)
+    , bodyRemaining_(0)
+    , maxBodySize_(kDefaultMaxBodySize)
+    , error_(kNoError)
     {}
 
+    void setBodyStreamSelector(const BodyStreamSelector& selector)
+    { bodyStreamSelector_ = selector; }
+
+    void setMaxBodySize(uint64_t bytes)
+    { maxBodySize_ = bytes; }
+
+    ParseError parseError() const
+    { return error_; }
+
     bool parseRequest(muduo::net::Buffer* buf, muduo::Timestamp receiveTime);
     bool gotAll() const 
     { return state_ == kGotAll;  }
@@ -31,21 +83,75 @@ public:
     void reset()
     {
         state_ = kExpectRequestLine;
-        HttpRequest dummyData;
-        request_.swap(dummyData);
+        parsedBytes_ = 0;
+        base_ = nullptr;
+        chunked_ = false;
+        bodyRemaining_ = 0;
+        bodyCallback_ = nullptr;
+        error_ = kNoError;
+        request_.reset();
     }
 
+    // 当前请求在输入缓冲区中已解析（且尚未回收）的字节数，请求处理完成（响应发送）后再从缓冲区中回收
+    size_t requestBytes() const
+    { return parsedBytes_; }
+
     const HttpRequest& request() const
     { return request_;}
 
     HttpRequest& request()
     { return request_;}
 
+    // 文件响应发送完成之前，同一连接上后续的（流水线）请求先留在输入缓冲区中。
+    // 不受 reset() 影响
+    void setFileTransfer(const std::shared_ptr<FileTransfer>& transfer)
+    { fileTransfer_ = transfer; }
+
+    const std::shared_ptr<FileTransfer>& fileTransfer() const
+    { return fileTransfer_; }
+
+    // 请求已投递到工作线程池、响应还没有发出。期间同一连接上后续的（流水线）请求先留在输入缓冲区中，
+    // 保证响应按请求的顺序发出。不受 reset() 影响
+    void setResponsePending(bool pending)
+    { responsePending_ = pending; }
+
+    bool responsePending() const
+    { return responsePending_; }
+
+    // 待写出的响应：一次 onMessage 中产生的响应先追加到这里，处理完后一次写到连接（HttpServer::flushResponses）。
+    // 每次回调结束时都已清空，保留容量供后续复用
+    muduo::net::Buffer* outputBatch()
+    { return &outputBatch_; }
+
 private:
     bool processRequestLine(const char* begin, const char* end);
+    // 检查 Content-Length / Transfer-Encoding，报文有歧义（可能被用于请求走私）时返回 false
+    bool parseBodyLength(uint64_t* length, bool* hasLength);
+    // 处理请求头结束的空行，判断是否需要继续读取请求体
+    bool processHeadersEnd();
+    // 解析分块长度行，返回 false 表示格式错误
+    bool processChunkSize(const char* begin, const char* end);
+    // 交付一段请求体数据：流式模式交给回调，否则追加到请求体中
+    void deliverBody(const char* data, size_t len);
+    // 请求头之后的数据不再原地引用：拷贝请求头并回收缓冲区中已解析的部分
+    void detachHead(muduo::net::Buffer* buf);
 private:
+    static const size_t kMaxScanLines = 32; // 单次扫描最多输出的行数
+
     HttpRequestParseState state_;
     HttpRequest           request_;
+    size_t                parsedBytes_; // 相对于 buf->peek() 的解析进度，解析过程中不回收缓冲区
+    const char*           base_; // 上一次解析时 buf->peek() 的位置，用于检测缓冲区搬移
+    std::array<HeaderScanner::Line, kMaxScanLines> lines_; // 请求头扫描结果
+    bool                  chunked_; // 请求体是否为分块编码
+    uint64_t              bodyRemaining_; // 当前分块（或流式请求体）剩余的字节数
+    uint64_t              maxBodySize_; // 整体缓存的请求体上限
+    ParseError            error_;
+    BodyStreamSelector    bodyStreamSelector_;
+    BodyCallback          bodyCallback_; // 非空表示当前请求以流式方式接收请求体
+    std::shared_ptr<FileTransfer> fileTransfer_; // 非空表示文件响应还没有发送完
+    bool                  responsePending_ { false };
+    muduo::net::Buffer    outputBatch_;
 };
 
 } // namespace http
\ No newline at end of file
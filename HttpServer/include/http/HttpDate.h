@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace http
+{
+
+// HTTP 日期（RFC 7231 IMF-fixdate，如 "Sun, 06 Nov 1994 08:49:37 GMT"）
+class HttpDate
+{
+public:
+    static const size_t kLength = 29; // IMF-fixdate 固定长度
+
+    // 当前时间的 "Date: ...\r\n" 响应头。每个线程（事件循环）缓存一份，每秒最多格式化一次
+    static std::string_view header();
+
+    // 格式化任意时间，写入 buf（至少 kLength 字节），返回写入的长度
+    static size_t format(time_t seconds, char* buf);
+    static std::string format(time_t seconds);
+
+    // 解析 IMF-fixdate（If-Modified-Since 等请求头），格式不对时返回 false
+    static bool parse(std::string_view date, time_t* seconds);
+};
+
+} // namespace http
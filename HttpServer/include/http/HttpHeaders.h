@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace http
+{
+
+// 常用头部字段，解析时识别出来放入固定槽位，按 id 访问是 O(1)
+enum class HeaderId : uint8_t
+{
+    kHost,
+    kConnection,
+    kContentLength,
+    kContentType,
+    kCookie,
+    kOrigin,
+    kTransferEncoding,
+    kCount, // 常用字段个数
+    kOther = kCount, // 其他字段
+};
+
+// 大小写不敏感的字段名识别，不是常用字段时返回 HeaderId::kOther
+HeaderId lookupHeaderId(std::string_view name);
+
+// 常用字段的规范写法（如 "Content-Length"）
+std::string_view headerName(HeaderId id);
+
+// ASCII 大小写不敏感比较
+bool iequals(std::string_view a, std::string_view b);
+
+// 扁平的头部表：所有字段按出现顺序连续存放，常用字段额外记录下标，
+// 名字比较大小写不敏感。请求使用 string_view（引用输入缓冲区），响应使用 std::string
+template <typename String>
+class BasicHttpHeaders
+{
+public:
+    struct Field
+    {
+        HeaderId id;
+        String   name;
+        String   value;
+    };
+
+    using Fields         = std::vector<Field>;
+    using iterator       = typename Fields::iterator;
+    using const_iterator = typename Fields::const_iterator;
+
+    BasicHttpHeaders()
+    { slots_.fill(kNoSlot); }
+
+    // 追加字段，同名字段以最后一个为准（请求解析使用）
+    void add(std::string_view name, std::string_view value)
+    {
+        HeaderId id = lookupHeaderId(name);
+        fields_.push_back(Field{id, String(name), String(value)});
+        if (id != HeaderId::kOther)
+        {
+            size_t index = fields_.size() - 1;
+            slots_[static_cast<size_t>(id)] = index < kNoSlot ? static_cast<uint8_t>(index) : kNoSlot;
+        }
+    }
+
+    // 设置字段，已存在则替换（响应使用）
+    void set(std::string_view name, std::string_view value)
+    {
+        size_t index = indexOf(name);
+        if (index != kNotFound)
+        {
+            fields_[index].value = String(value);
+        }
+        else
+        {
+            add(name, value);
+        }
+    }
+
+    void set(HeaderId id, std::string_view value)
+    { set(headerName(id), value); }
+
+    // 查找字段值，不存在时返回空
+    std::string_view get(HeaderId id) const
+    {
+        size_t index = indexOf(id);
+        return index != kNotFound ? std::string_view(fields_[index].value) : std::string_view();
+    }
+
+    std::string_view get(std::string_view name) const
+    {
+        size_t index = indexOf(name);
+        return index != kNotFound ? std::string_view(fields_[index].value) : std::string_view();
+    }
+
+    bool contains(HeaderId id) const
+    { return indexOf(id) != kNotFound; }
+
+    bool contains(std::string_view name) const
+    { return indexOf(name) != kNotFound; }
+
+    void clear()
+    {
+        fields_.clear();
+        slots_.fill(kNoSlot);
+    }
+
+    size_t size() const { return fields_.size(); }
+    bool empty() const { return fields_.empty(); }
+
+    iterator begin() { return fields_.begin(); }
+    iterator end() { return fields_.end(); }
+    const_iterator begin() const { return fields_.begin(); }
+    const_iterator end() const { return fields_.end(); }
+
+private:
+    static constexpr uint8_t kNoSlot = 0xFF;
+    static constexpr size_t  kNotFound = static_cast<size_t>(-1);
+
+    size_t indexOf(HeaderId id) const
+    {
+        if (id == HeaderId::kOther)
+        {
+            return kNotFound;
+        }
+        uint8_t slot = slots_[static_cast<size_t>(id)];
+        if (slot != kNoSlot)
+        {
+            return slot;
+        }
+        // 超过 255 个字段时槽位放不下，退化为线性查找
+        return fields_.size() >= kNoSlot ? indexOfLinear(id, headerName(id)) : kNotFound;
+    }
+
+    size_t indexOf(std::string_view name) const
+    {
+        HeaderId id = lookupHeaderId(name);
+        return id != HeaderId::kOther ? indexOf(id) : indexOfLinear(id, name);
+    }
+
+    size_t indexOfLinear(HeaderId id, std::string_view name) const
+    {
+        for (size_t i = fields_.size(); i > 0; --i)
+        {
+            const Field& field = fields_[i - 1];
+            if (field.id == id && iequals(field.name, name))
+            {
+                return i - 1;
+            }
+        }
+        return kNotFound;
+    }
+
+private:
+    Fields                                                   fields_; // 按出现顺序存放的字段
+    std::array<uint8_t, static_cast<size_t>(HeaderId::kCount)> slots_; // 常用字段在 fields_ 中的下标
+};
+
+using RequestHeaders  = BasicHttpHeaders<std::string_view>;
+using ResponseHeaders = BasicHttpHeaders<std::string>;
+
+} // namespace http
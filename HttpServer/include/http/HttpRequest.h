@@ -1,14 +1,90 @@
 #pragma once
 
+#include <array>
 #include <map>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <muduo/base/Timestamp.h>
 
+#include "AuthContext.h"
+#include "Cookies.h"
+#include "HttpHeaders.h"
+
 namespace http
 {
 
+class HttpResponse;
+
+// 路由匹配得到的路径参数，固定容量的内联数组，不分配内存。
+// 名字引用路由表中的字符串，值引用请求路径
+class PathParams
+{
+public:
+    struct Param
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    static constexpr size_t kCapacity = 8;
+
+    bool push(std::string_view name, std::string_view value)
+    {
+        if (size_ == kCapacity)
+        {
+            return false;
+        }
+        params_[size_++] = Param{ name, value };
+        return true;
+    }
+
+    void pop()
+    { --size_; }
+
+    void truncate(size_t size)
+    { size_ = size; }
+
+    void clear()
+    { size_ = 0; }
+
+    size_t size() const
+    { return size_; }
+
+    // 没有该参数时返回空
+    std::string_view get(std::string_view name) const
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            if (params_[i].name == name)
+            {
+                return params_[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    Param* begin() { return params_.data(); }
+    Param* end() { return params_.data() + size_; }
+    const Param* begin() const { return params_.data(); }
+    const Param* end() const { return params_.data() + size_; }
+
+private:
+    std::array<Param, kCapacity> params_;
+    size_t                       size_ { 0 };
+};
+
+namespace session
+{
+class Session;
+} // namespace session
+
+// 请求报文的各个字段以 string_view 的形式直接引用连接输入缓冲区中的数据（零拷贝），
+// 在响应发送完成之前缓冲区中的数据不会被回收；
+// 如果需要在当前回调之外继续使用请求（例如投递到其他线程），先调用 detach() 拷贝一份私有数据
 class HttpRequest
 {
 public:
@@ -16,74 +92,159 @@ public:
     {
         kInvalid, kGet, kPost, kHead, kPut, kDelete, kOptions
     };
-    
+
     HttpRequest()
         : method_(kInvalid)
         , version_("Unknown")
     {
     }
-    
+
     void setReceiveTime(muduo::Timestamp t);
     muduo::Timestamp receiveTime() const { return receiveTime_; }
-    
+
     bool setMethod(const char* start, const char* end);
     Method method() const { return method_; }
 
     void setPath(const char* start, const char* end);
-    std::string path() const { return path_; }
+    std::string path() const { return std::string(path_); }
+    std::string_view pathView() const { return path_; }
 
-    void setPathParameters(const std::string &key, const std::string &value);
-    std::string getPathParameters(const std::string &key) const;
+    // 路径参数（如 /user/:id 中的 id），由路由匹配时设置
+    PathParams& pathParams() { return pathParams_; }
+    const PathParams& pathParams() const { return pathParams_; }
+    std::string_view pathParam(std::string_view name) const
+    { return pathParams_.get(name); }
+    std::string getPathParameters(const std::string &key) const
+    { return std::string(pathParams_.get(key)); }
 
     void setQueryParameters(const char* start, const char* end);
     std::string getQueryParameters(const std::string &key) const;
-    
+    std::string_view queryParameter(std::string_view key) const;
+
     void setVersion(std::string v)
     {
         version_ = v;
     }
 
-    std::string getVersion() const
+    const std::string& getVersion() const
     {
         return version_;
     }
-    
+
     void addHeader(const char* start, const char* colon, const char* end);
     std::string getHeader(const std::string& field) const;
+    std::string_view header(std::string_view field) const
+    { return headers_.get(field); }
+    std::string_view header(HeaderId id) const
+    { return headers_.get(id); }
 
-    const std::map<std::string, std::string>& headers() const
+    const RequestHeaders& headers() const
     { return headers_; }
 
-    void setBody(const std::string& body) { content_ = body; }
-    void setBody(const char* start, const char* end) 
-    { 
-        if (end >= start) 
+    // 请求携带的 Cookie：第一次访问时解析 Cookie 头，同一个请求只解析一次
+    const RequestCookies& cookies() const;
+    std::string_view cookie(std::string_view name) const
+    { return cookies().get(name); }
+
+    void setBody(const std::string& body);
+    void setBody(const char* start, const char* end)
+    {
+        if (end >= start)
         {
-            content_.assign(start, end - start); 
+            content_ = std::string_view(start, end - start);
         }
     }
-    
+
+    // 追加请求体数据（分块编码的请求体解码后无法原地引用缓冲区）
+    void appendBody(const char* data, size_t len);
+
     std::string getBody() const
+    { return std::string(content_); }
+
+    std::string_view body() const
     { return content_; }
 
     void setContentLength(uint64_t length)
     { contentLength_ = length; }
-    
+
     uint64_t contentLength() const
     { return contentLength_; }
 
+    // 请求体已经通过流式回调逐块交付，body() 为空
+    void setBodyStreamed(bool on)
+    { bodyStreamed_ = on; }
+
+    bool bodyStreamed() const
+    { return bodyStreamed_; }
+
+    // 记录请求报文在输入缓冲区中占用的区间 [begin, begin + len)
+    void pin(const char* begin, size_t len)
+    {
+        base_ = begin;
+        length_ = len;
+    }
+
+    // 输入缓冲区搬移了数据（muduo::Buffer::makeSpace），把所有视图平移到新的位置
+    void rebase(const char* oldBase, const char* newBase);
+
+    // 拷贝一份私有数据并让所有视图指向它，之后请求不再依赖连接的输入缓冲区
+    void detach();
+
+    // 清空请求内容，保留 headers_ 的容量供下一个请求复用
+    void reset();
+
     void swap(HttpRequest& that);
 
+    // 本次请求绑定的会话：SessionManager::getSession 第一次调用时绑定，之后直接返回同一个会话，
+    // 请求结束时由 HttpServer 调用 SessionManager::commit 统一保存。
+    // 处理器拿到的是 const 请求，绑定会话不算修改请求内容，因此是 mutable
+    const std::shared_ptr<session::Session>& session() const
+    { return session_; }
+
+    void setSession(std::shared_ptr<session::Session> session) const
+    { session_ = std::move(session); }
+
+    // 本次请求的用户身份，由 AuthMiddleware 设置；没有经过鉴权中间件时是未登录的访客
+    const AuthContext& auth() const
+    { return auth_; }
+
+    void setAuth(const AuthContext& auth) const
+    { auth_ = auth; }
+
+    // 流式接收请求体的请求在请求头到达时就执行了前置中间件和登录检查（HttpServer::selectBodyStream），
+    // 请求体收完后不再重复执行：depth 交给 processAfter；rejection 非空表示请求已被拒绝，直接发送它
+    struct BeforeResult
+    {
+        size_t                        depth = 0;
+        std::shared_ptr<HttpResponse> rejection;
+    };
+
+    const std::shared_ptr<BeforeResult>& beforeResult() const
+    { return beforeResult_; }
+
+    void setBeforeResult(std::shared_ptr<BeforeResult> result)
+    { beforeResult_ = std::move(result); }
+
 private:
     Method                                       method_; // 请求方法
     std::string                                  version_; // http版本
-    std::string                                  path_; // 请求路径
-    std::unordered_map<std::string, std::string> pathParameters_; // 路径参数
-    std::unordered_map<std::string, std::string> queryParameters_; // 查询参数
+    std::string_view                             path_; // 请求路径
+    std::string_view                             query_; // 查询参数（?之后的原始字符串）
+    PathParams                                   pathParams_; // 路径参数
     muduo::Timestamp                             receiveTime_; // 接收时间
-    std::map<std::string, std::string>           headers_; // 请求头
-    std::string                                  content_; // 请求体
+    RequestHeaders                               headers_; // 请求头（名字大小写不敏感）
+    std::string_view                             content_; // 请求体
     uint64_t                                     contentLength_ { 0 }; // 请求体长度
-};  
+    bool                                         bodyStreamed_ { false }; // 请求体是否以流式方式交付
+    const char*                                  base_ { nullptr }; // 报文起始位置
+    size_t                                       length_ { 0 }; // 报文长度
+    std::shared_ptr<const std::string>           storage_; // detach() 之后的私有数据
+    std::shared_ptr<std::string>                 bodyStorage_; // setBody(std::string)/appendBody() 设置的请求体
+    mutable std::shared_ptr<session::Session>    session_; // 本次请求绑定的会话
+    mutable RequestCookies                       cookies_; // 按需解析的 Cookie，引用请求头
+    mutable bool                                 cookiesParsed_ { false };
+    mutable AuthContext                          auth_; // 本次请求的用户身份
+    std::shared_ptr<BeforeResult>                beforeResult_; // 已经提前执行的前置中间件的结果
+};
 
-} // namespace http
\ No newline at end of file
+} // namespace http
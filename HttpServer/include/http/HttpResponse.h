@@ -1,7 +1,16 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include <muduo/net/TcpServer.h>
 
+#include "FileBody.h"
+#include "HttpHeaders.h"
+
 namespace http
 {
 
@@ -13,18 +22,25 @@ public:
         kUnknown,
         k200Ok = 200,
         k204NoContent = 204,
+        k206PartialContent = 206,
         k301MovedPermanently = 301,
+        k304NotModified = 304,
         k400BadRequest = 400,
         k401Unauthorized = 401,
         k403Forbidden = 403,
         k404NotFound = 404,
         k409Conflict = 409,
+        k416RangeNotSatisfiable = 416,
         k500InternalServerError = 500,
+        k503ServiceUnavailable = 503,
     };
 
     HttpResponse(bool close = true)
-        : statusCode_(kUnknown)
+        : httpVersion_("HTTP/1.1")
+        , statusCode_(kUnknown)
         , closeConnection_(close)
+        , contentLength_(-1)
+        , isFile_(false)
     {}
 
     void setVersion(std::string version)
@@ -45,35 +61,179 @@ public:
     { return closeConnection_; }
     
     void setContentType(const std::string& contentType)
-    { addHeader("Content-Type", contentType); }
+    { headers_.set(HeaderId::kContentType, contentType); }
 
+    // 不设置时序列化按 body 长度自动生成 Content-Length
     void setContentLength(uint64_t length)
-    { addHeader("Content-Length", std::to_string(length)); }
+    { contentLength_ = static_cast<int64_t>(length); }
 
+    // 同名字段（大小写不敏感）已存在时替换
     void addHeader(const std::string& key, const std::string& value)
-    { headers_[key] = value; }
+    { headers_.set(key, value); }
+
+    std::string_view getHeader(std::string_view key) const
+    { return headers_.get(key); }
+
+    // 在 Vary 中加入 field（已包含或为 "*" 时不变）
+    void addVary(std::string_view field);
+
+    // 追加预先格式化好的响应头（一行或多行 "Name: value\r\n"），序列化时原样写出。
+    // 只保存引用：数据由调用方持有（如中间件构造时生成的头部），需在响应发送之前一直有效；
+    // 这些字段不会出现在 getHeader() / headers() 中
+    void appendRawHeaders(std::string_view block)
+    { rawHeaders_.push_back(block); }
+
+    const ResponseHeaders& headers() const
+    { return headers_; }
     
-    void setBody(const std::string& body)
+    // 响应体以值传入，调用方可以 std::move 避免拷贝
+    void setBody(std::string body)
     { 
-        body_ = body;
-        // body_ += "\0";
+        clearBody();
+        body_ = std::move(body);
+    }
+
+    // 共享的只读响应体（如缓存的静态文件），发送时直接引用，不拷贝
+    void setBody(std::shared_ptr<const std::string> body)
+    {
+        clearBody();
+        sharedBody_ = std::move(body);
+    }
+
+    // 分段的响应体（如模板渲染结果）：各段引用 owner 持有的数据，发送时依次写出，不拼接成一个字符串
+    void setBody(std::shared_ptr<const void> owner, std::vector<std::string_view> segments)
+    {
+        clearBody();
+        segmentsOwner_ = std::move(owner);
+        segments_ = std::move(segments);
+    }
+
+    // 单段的响应体；分段或文件响应体时为空
+    std::string_view body() const
+    { return sharedBody_ ? std::string_view(*sharedBody_) : std::string_view(body_); }
+
+    bool isSegmented() const
+    { return segmentsOwner_ != nullptr; }
+
+    const std::vector<std::string_view>& segments() const
+    { return segments_; }
+
+    // 当前响应体预先压缩好的版本（静态资源缓存加载时生成），压缩阶段按 Accept-Encoding 直接选用。
+    // 重新设置响应体时清空
+    void setPrecompressed(std::shared_ptr<const std::string> gzip, std::shared_ptr<const std::string> brotli)
+    {
+        gzipBody_ = std::move(gzip);
+        brotliBody_ = std::move(brotli);
+    }
+
+    const std::shared_ptr<const std::string>& gzipBody() const
+    { return gzipBody_; }
+
+    const std::shared_ptr<const std::string>& brotliBody() const
+    { return brotliBody_; }
+
+    // 关闭现场压缩：没有预压缩版本时压缩阶段直接发送原文（如预压缩还在后台进行的静态文件）。
+    // 重新设置响应体时恢复
+    void setLiveCompression(bool on)
+    { liveCompression_ = on; }
+
+    bool liveCompression() const
+    { return liveCompression_; }
+
+    // 响应体的总长度（不论以哪种形式保存）
+    size_t bodySize() const;
+
+    // 以文件作为响应体，发送时由 HttpServer 分块读出发送，Content-Length 取文件大小。
+    // 文件无法打开时返回 false，响应保持不变
+    bool setFile(const std::string& path)
+    {
+        std::shared_ptr<const FileBody> file = FileBody::open(path);
+        if (!file)
+        {
+            return false;
+        }
+        setFile(std::move(file));
+        return true;
+    }
+
+    void setFile(std::shared_ptr<const FileBody> file)
+    {
+        clearBody();
+        fileLength_ = file->size();
+        file_ = std::move(file);
+        isFile_ = true;
+    }
+
+    // 只发送文件的 [offset, offset + length)（Range 请求），需先 setFile
+    void setFileRange(size_t offset, size_t length)
+    {
+        fileOffset_ = offset;
+        fileLength_ = length;
     }
 
+    size_t fileOffset() const
+    { return fileOffset_; }
+
+    size_t fileLength() const
+    { return fileLength_; }
+
+    bool isFile() const
+    { return isFile_; }
+
+    const std::shared_ptr<const FileBody>& file() const
+    { return file_; }
+
     void setStatusLine(const std::string& version,
                          HttpStatusCode statusCode,
                          const std::string& statusMessage);
 
     void setErrorHeader(){}
 
-    void appendToBuffer(muduo::net::Buffer* outputBuf) const;
+    // 序列化响应报文：状态行取预先渲染好的表，附带缓存的 Date 头和 Content-Length，
+    // 先计算总长度，只扩容一次输出缓冲区，再直接写入
+    void appendToBuffer(muduo::net::Buffer* outputBuf) const
+    { serialize(outputBuf, true); }
+
+    // 只序列化状态行和响应头，响应体由调用方用 body() / segments() / file() 单独发送，不拷贝进输出缓冲区
+    void appendHeadersToBuffer(muduo::net::Buffer* outputBuf) const
+    { serialize(outputBuf, false); }
+private:
+    void serialize(muduo::net::Buffer* outputBuf, bool withBody) const;
+
+    void clearBody()
+    {
+        body_.clear();
+        sharedBody_.reset();
+        segmentsOwner_.reset();
+        segments_.clear();
+        file_.reset();
+        isFile_ = false;
+        fileOffset_ = 0;
+        fileLength_ = 0;
+        gzipBody_.reset();
+        brotliBody_.reset();
+        liveCompression_ = true;
+    }
+
 private:
     std::string                        httpVersion_; 
     HttpStatusCode                     statusCode_;
     std::string                        statusMessage_;
     bool                               closeConnection_;
-    std::map<std::string, std::string> headers_;
+    ResponseHeaders                    headers_;
+    std::vector<std::string_view>      rawHeaders_; // appendRawHeaders 追加的预格式化头部
+    int64_t                            contentLength_; // -1 表示按响应体长度计算
     std::string                        body_;
-    bool                               isFile_;
+    std::shared_ptr<const std::string> sharedBody_; // 非空时代替 body_
+    std::shared_ptr<const void>        segmentsOwner_; // 非空表示响应体是 segments_
+    std::vector<std::string_view>      segments_;
+    bool                               isFile_; // 响应体是文件（file_）
+    std::shared_ptr<const FileBody>    file_;
+    size_t                             fileOffset_ { 0 };
+    size_t                             fileLength_ { 0 };
+    std::shared_ptr<const std::string> gzipBody_; // 预压缩的响应体
+    std::shared_ptr<const std::string> brotliBody_;
+    bool                               liveCompression_ { true };
 };
 
 } // namespace http
\ No newline at end of file
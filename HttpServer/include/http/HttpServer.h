@@ -17,12 +17,21 @@
 #include "HttpContext.h"
 #include "HttpRequest.h"
 #include "HttpResponse.h"
+#include "../async/Awaitables.h"
+#include "../async/Task.h"
 #include "../router/Router.h"
+#include "../router/StaticRouter.h"
 #include "../session/SessionManager.h"
+#include "../session/MmapSessionStorage.h"
+#include "../session/ShardedSessionStorage.h"
 #include "../middleware/MiddlewareChain.h"
+#include "../middleware/Pipeline.h"
+#include "../middleware/auth/AuthMiddleware.h"
 #include "../middleware/cors/CorsMiddleware.h"
+#include "../middleware/compress/CompressionStage.h"
 #include "../ssl/SslConnection.h"
 #include "../ssl/SslContext.h"
+#include "../utils/WorkerPool.h"
 
 class HttpRequest;
 class HttpResponse;
@@ -33,7 +42,8 @@ namespace http
 class HttpServer : muduo::noncopyable
 {
 public:
-    using HttpCallback = std::function<void (const http::HttpRequest&, http::HttpResponse*)>;
+    // 请求对象直接交给中间件和路由使用（不再拷贝），因此这里传入可修改的引用
+    using HttpCallback = std::function<void (http::HttpRequest&, http::HttpResponse*)>;
     
     // 构造函数
     HttpServer(int port,
@@ -59,7 +69,7 @@ public:
     }
 
     // 注册静态路由处理器
-    void Get(const std::string& path, const HttpCallback& cb)
+    void Get(const std::string& path, const router::Router::HandlerCallback& cb)
     {
         router_.registerCallback(HttpRequest::kGet, path, cb);
     }
@@ -70,7 +80,19 @@ public:
         router_.registerHandler(HttpRequest::kGet, path, handler);
     }
 
-    void Post(const std::string& path, const HttpCallback& cb)
+    // 注册协程式处理器（GET）
+    void Get(const std::string& path, router::Router::AsyncHandlerPtr handler)
+    {
+        router_.registerAsyncHandler(HttpRequest::kGet, path, handler);
+    }
+
+    // 协程式处理函数单独命名：返回 Task 的 lambda 也能转换成返回 void 的 HandlerCallback，重载会有歧义
+    void GetAsync(const std::string& path, const router::Router::AsyncCallback& cb)
+    {
+        router_.registerAsyncCallback(HttpRequest::kGet, path, cb);
+    }
+
+    void Post(const std::string& path, const router::Router::HandlerCallback& cb)
     {
         router_.registerCallback(HttpRequest::kPost, path, cb);
     }
@@ -80,21 +102,82 @@ public:
         router_.registerHandler(HttpRequest::kPost, path, handler);
     }
 
-    // 注册动态路由处理器
+    void Post(const std::string& path, router::Router::AsyncHandlerPtr handler)
+    {
+        router_.registerAsyncHandler(HttpRequest::kPost, path, handler);
+    }
+
+    void PostAsync(const std::string& path, const router::Router::AsyncCallback& cb)
+    {
+        router_.registerAsyncCallback(HttpRequest::kPost, path, cb);
+    }
+
+    // 为 GET 路由配置 Cache-Control（如 "no-cache"、"public, max-age=3600"）
+    void setCacheControl(const std::string& path, const std::string& value)
+    {
+        router_.setCacheControl(HttpRequest::kGet, path, value);
+    }
+
+    // 开启工作线程池，最多排队 maxQueued 个请求，超过时返回 503。需在 start() 之前调用
+    void setWorkerThreads(size_t numThreads, size_t maxQueued = 1024)
+    {
+        workerPool_ = std::make_unique<WorkerPool>(numThreads, maxQueued);
+    }
+
+    // 工作线程池，供协程式处理器 co_await async::runInPool(...) 使用；没有开启时为空（在 IO 线程中直接执行）
+    WorkerPool* workerPool() const
+    {
+        return workerPool_.get();
+    }
+
+    // 标记会阻塞的路由（数据库访问、耗时计算）：处理器在工作线程池中执行，不占用 IO 线程。
+    // 没有开启工作线程池时仍在 IO 线程中执行
+    void setBlocking(HttpRequest::Method method, const std::string& path)
+    {
+        router_.setBlocking(method, path);
+    }
+
+    // 标记需要登录的路由：未登录的请求直接返回 401，不进入处理器。需要注册 AuthMiddleware 解析身份
+    void setAuthRequired(HttpRequest::Method method, const std::string& path)
+    {
+        router_.setAuthRequired(method, path);
+    }
+
+    // 注册任意方法的路由处理器，路径可以带参数（/user/:id）或通配（/static/*filepath）
     void addRoute(HttpRequest::Method method, const std::string& path, router::Router::HandlerPtr handler)
     {
-        router_.addRegexHandler(method, path, handler);
+        router_.registerHandler(method, path, handler);
     }
 
-    // 注册动态路由处理函数
+    // 注册任意方法的路由处理函数
     void addRoute(HttpRequest::Method method, const std::string& path, const router::Router::HandlerCallback& callback)
     {
-        router_.addRegexCallback(method, path, callback);
+        router_.registerCallback(method, path, callback);
+    }
+
+    // 设置编译期静态路由表（router::makeStaticRouter），请求先在静态路由表中查找，没有命中再交给动态路由。
+    // 静态路由在 IO 线程中同步执行，协程式和阻塞路由仍需注册到动态路由
+    template <typename... Routes>
+    void setStaticRouter(router::StaticRouter<Routes...> routes)
+    {
+        using Table = router::StaticRouter<Routes...>;
+        staticRoutes_.router = std::make_shared<Table>(std::move(routes));
+        staticRoutes_.route = [](void* table, const HttpRequest& req, HttpResponse* resp) {
+            return static_cast<Table*>(table)->route(req, resp);
+        };
+        staticRoutes_.contains = [](const HttpRequest& req) {
+            return Table::find(req.method(), req.pathView()) >= 0;
+        };
     }
 
     // 设置会话管理器
     void setSessionManager(std::unique_ptr<session::SessionManager> manager)
     {
+        // HTTPS 下会话 Cookie 只在加密连接上发送
+        if (manager && useSSL_)
+        {
+            manager->setSecureCookie(true);
+        }
         sessionManager_ = std::move(manager);
     }
 
@@ -110,23 +193,93 @@ public:
         middlewareChain_.addMiddleware(middleware);
     }
 
+    // 添加只对某个路径前缀生效的中间件（"/api" 匹配 /api 和 /api/...），
+    // 可以是 middleware::makePipeline(...) 在编译期组合的流水线
+    void addMiddleware(const std::string& prefix, std::shared_ptr<middleware::Middleware> middleware)
+    {
+        middlewareChain_.addMiddleware(prefix, middleware);
+    }
+
+    // 开启响应压缩（在所有中间件的 after 之后执行）
+    void enableCompression(const middleware::CompressionConfig& config = middleware::CompressionConfig::defaultConfig())
+    {
+        compressionStage_ = std::make_unique<middleware::CompressionStage>(config);
+    }
+
     void enableSSL(bool enable) 
     {
         useSSL_ = enable;
+        if (enable && sessionManager_)
+        {
+            sessionManager_->setSecureCookie(true);
+        }
     }
 
     void setSslConfig(const ssl::SslConfig& config);
 
+    // 整体缓存的请求体上限（默认 8MB），超过时回复 413 并关闭连接；流式接收请求体的处理器不受限制
+    void setMaxBodySize(uint64_t bytes)
+    {
+        maxBodySize_ = bytes;
+    }
+
 private:
+    static constexpr size_t kInlineBodyLimit = 4096; // 不超过该长度的响应体拼在头部后面一次发送
+    static constexpr size_t kFileChunkSize = 64 * 1024; // 文件响应每次读取发送的最大字节数
+    static constexpr size_t kBatchFlushBytes = 64 * 1024; // 输出批次超过该长度时不再等待，提前写出
+
     void initialize();
 
     void onConnection(const muduo::net::TcpConnectionPtr& conn);
     void onMessage(const muduo::net::TcpConnectionPtr& conn,
                    muduo::net::Buffer* buf,
                    muduo::Timestamp receiveTime);
-    void onRequest(const muduo::net::TcpConnectionPtr&, const HttpRequest&);
+    void processRequests(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                         muduo::net::Buffer* buf, muduo::Timestamp receiveTime);
+    void resumeRequests(const muduo::net::TcpConnectionPtr& conn, HttpContext* context);
+    void onRequest(const muduo::net::TcpConnectionPtr&, HttpContext* context);
+    // 响应先追加到连接的输出批次，flushResponses 时一次写出
+    void sendResponse(const muduo::net::TcpConnectionPtr& conn, HttpResponse& response, HttpContext* context);
+    void flushResponses(const muduo::net::TcpConnectionPtr& conn, HttpContext* context);
+    void sendData(const muduo::net::TcpConnectionPtr& conn, const char* data, size_t len);
+    // 先写出已经排队的响应（保持流水线请求的响应顺序），再回复 400（请求体过大时 413）并关闭连接
+    void sendErrorAndClose(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                           HttpContext::ParseError error = HttpContext::kBadRequest);
+    static bool shouldClose(const HttpRequest& req);
+
+    // 阻塞路由（setBlocking）的请求在工作线程池中处理，响应回到 IO 线程发送
+    void dispatchToWorker(const muduo::net::TcpConnectionPtr& conn, HttpContext* context);
+
+    // 协程式处理器：在 IO 线程中启动协程，挂起期间连接上的后续请求等待
+    void dispatchAsync(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                       const router::Router::Route* route);
+    async::Detached runAsync(muduo::net::TcpConnectionPtr conn, std::shared_ptr<HttpRequest> req,
+                             const router::Router::Route* route);
+
+    // 工作线程 / 协程生成的响应回到 IO 线程后发送，然后继续处理连接上的后续请求
+    void onAsyncResponse(const muduo::net::TcpConnectionPtr& conn, HttpResponse& response);
+    void onWriteComplete(const muduo::net::TcpConnectionPtr& conn);
+
+    // 文件响应（HttpResponse::setFile）的发送
+    void sendFile(const muduo::net::TcpConnectionPtr& conn, HttpContext* context);
+
+    void handleRequest(HttpRequest& req, HttpResponse* resp);
+    HttpContext::BodyCallback selectBodyStream(HttpRequest& req);
+
+    // 静态路由表的类型擦除：具体类型的 StaticRouter 加两个普通函数指针，
+    // 调用时只有一次间接调用，不经过 std::function
+    struct StaticRoutes
+    {
+        std::shared_ptr<void> router;
+        bool (*route)(void* router, const HttpRequest& req, HttpResponse* resp) = nullptr;
+        bool (*contains)(const HttpRequest& req) = nullptr;
+    };
+
+    bool isStaticRoute(const HttpRequest& req) const
+    { return staticRoutes_.contains && staticRoutes_.contains(req); }
 
-    void handleRequest(const HttpRequest& req, HttpResponse* resp);
+    bool routeStatic(const HttpRequest& req, HttpResponse* resp)
+    { return staticRoutes_.route && staticRoutes_.route(staticRoutes_.router.get(), req, resp); }
     
 private:
     muduo::net::InetAddress                      listenAddr_; // 监听地址
@@ -134,12 +287,17 @@ private:
     muduo::net::EventLoop                        mainLoop_; // 主循环
     HttpCallback                                 httpCallback_; // 回调函数
     router::Router                               router_; // 路由
+    StaticRoutes                                 staticRoutes_; // 编译期静态路由表，未设置时为空
     std::unique_ptr<session::SessionManager>     sessionManager_; // 会话管理器
     middleware::MiddlewareChain                  middlewareChain_; // 中间件链
+    std::unique_ptr<middleware::CompressionStage> compressionStage_; // 响应压缩，未开启时为空
     std::unique_ptr<ssl::SslContext>             sslCtx_; // SSL 上下文
     bool                                         useSSL_; // 是否使用 SSL   
+    uint64_t                                     maxBodySize_; // 整体缓存的请求体上限
     // TcpConnectionPtr -> SslConnectionPtr 
     std::map<muduo::net::TcpConnectionPtr, std::unique_ptr<ssl::SslConnection>> sslConns_;
+    // 最后声明、最先析构：先等工作线程退出，它们还在使用路由和中间件
+    std::unique_ptr<WorkerPool>                  workerPool_;
 }; 
 
 } // namespace http
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "HtmlTemplate.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+
+namespace http
+{
+
+// 进程级静态文件缓存：文件只在第一次请求（或文件变化后）读一次盘，
+// 内容以只读的共享缓冲区保存，响应时直接引用（HttpResponse::setBody(shared_ptr)），
+// ETag / Last-Modified / Content-Type 在加载时预先算好。
+// 通过 inotify 监视资源目录，文件被修改、替换或删除时失效对应条目，下次请求重新加载；
+// 事件队列溢出、目录本身被删除或替换时清空整个缓存，并重新监视该目录。
+// 可压缩的文件放入缓存后由后台线程以最高压缩率生成 gzip / brotli 版本，供压缩阶段直接选用；
+// 生成之前直接发送原文，不在 IO 线程中压缩。
+// 总内存超过上限时按 LRU 淘汰。
+// 按路径的哈希分片，每个分片一把锁、一条 LRU 链，不同文件的命中不争用同一把锁。
+// 失效时递增分片的代数，加载期间代数变化（文件在读盘时被修改）的结果不放入缓存，不会缓存旧内容
+class StaticFileCache
+{
+public:
+    struct Entry
+    {
+        std::shared_ptr<const std::string>  content;
+        std::string                         etag;         // 强 ETag（FileBody::etag）
+        std::string                         lastModified; // HTTP 日期
+        std::string                         mimeType;
+        time_t                              mtime;
+        std::shared_ptr<const HtmlTemplate> htmlTemplate; // 含 {{name}} 占位符的 HTML 页面，加载时预编译
+        std::shared_ptr<const std::string>  gzipContent;   // 预压缩版本，不值得压缩时为空
+        std::shared_ptr<const std::string>  brotliContent;
+        bool                                precompressPending = false; // 预压缩版本还在后台生成
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    // 单例模式
+    static StaticFileCache& getInstance()
+    {
+        static StaticFileCache instance;
+        return instance;
+    }
+
+    // 缓存内容的总字节数上限，超过时淘汰最久未使用的条目；单个超过上限的文件不缓存
+    void setMemoryLimit(size_t bytes);
+
+    // 监视目录（不递归），目录下的文件变化时失效对应的缓存。path 需与 get() 使用的路径前缀一致
+    bool watch(const std::string& dir);
+
+    // 取得文件的缓存条目，文件不存在或读取失败时返回 nullptr
+    EntryPtr get(const std::string& path);
+
+    // 把缓存的文件设置为响应体，同时设置 Content-Type / ETag / Last-Modified，
+    // 并处理条件请求（304）和 Range（206 / 416），见 StaticResource。文件不存在时返回 false
+    bool serve(const HttpRequest& req, const std::string& path, HttpResponse* resp);
+
+    void invalidate(const std::string& path);
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+    size_t memoryUsage() const;
+
+private:
+    StaticFileCache();
+    ~StaticFileCache();
+
+    // 禁止拷贝
+    StaticFileCache(const StaticFileCache&) = delete;
+    StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+    struct Slot
+    {
+        EntryPtr                         entry;
+        std::list<std::string>::iterator lru; // 在 Shard::lru 中的位置
+    };
+
+    // 每个分片独占缓存行，避免不同分片的锁伪共享
+    struct alignas(64) Shard
+    {
+        std::mutex                            mutex;
+        std::unordered_map<std::string, Slot> entries;
+        std::list<std::string>                lru;            // 头部是最近使用的
+        uint64_t                              generation = 0; // 每次失效递增
+    };
+
+    static EntryPtr load(const std::string& path);
+    Shard& shardFor(const std::string& path);
+    // 从分片的 LRU 尾部淘汰，直到总内存不超过上限或分片为空。调用方持有分片的锁
+    void evictLocked(Shard& shard);
+    // 依次淘汰各分片（每次只持有一个分片的锁），直到总内存不超过上限
+    void evict();
+    void watchLoop(); // inotify 事件处理线程
+    bool addWatch(const std::string& dir);
+    // 监视的目录被删除或移走：移除旧的 watch，重新监视同一路径（目录还不存在时之后重试），并清空缓存
+    void rewatch(int wd);
+    void retryLostWatches();
+    // 清空所有分片（不知道哪些文件变化了的时候）
+    void flushAll();
+    void schedulePrecompress(const std::string& path, const EntryPtr& entry);
+    void precompressLoop(); // 后台预压缩线程
+
+private:
+    static const size_t kShardCount = 16;
+
+    std::vector<std::unique_ptr<Shard>>   shards_;
+    std::atomic<size_t>                   memoryUsage_;
+    std::atomic<size_t>                   memoryLimit_;
+
+    std::atomic<uint64_t>                 hits_;
+    std::atomic<uint64_t>                 misses_;
+    std::atomic<uint64_t>                 evictions_;
+
+    int                                   inotifyFd_;
+    std::mutex                            watchMutex_;
+    std::unordered_map<int, std::string>  watches_; // watch descriptor -> 目录
+    std::atomic<bool>                     running_;
+    std::thread                           watchThread_;
+    std::vector<std::string>              lostWatches_; // 需要重新监视的目录，只在监视线程中访问
+
+    std::mutex                            compressMutex_;
+    std::condition_variable               compressCond_;
+    std::deque<std::pair<std::string, EntryPtr>> compressQueue_; // 等待预压缩的条目
+    bool                                  compressStopping_;
+    std::thread                           compressThread_;
+};
+
+} // namespace http
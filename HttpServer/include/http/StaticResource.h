@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+
+namespace http
+{
+
+// 静态资源的条件请求与 Range 请求：
+//  - 响应带上 ETag / Last-Modified，If-None-Match（优先）或 If-Modified-Since 命中时返回 304，不读取也不发送内容；
+//  - 支持单区间 Range（bytes=a-b / a- / -n），返回 206；区间无法满足时返回 416；
+//    多区间请求按完整内容返回 200；If-Range 与当前 ETag / Last-Modified 不一致时忽略 Range
+class StaticResource
+{
+public:
+    struct Validators
+    {
+        std::string_view etag;
+        time_t           mtime;
+        std::string_view lastModified;
+    };
+
+    enum RangeStatus
+    {
+        kFull,          // 没有（可用的）Range，返回完整内容
+        kPartial,       // 返回 [first, last]
+        kUnsatisfiable, // 416
+    };
+
+    // 以文件作为响应体（分块读取发送），并处理条件请求和 Range。文件不存在时返回 false
+    static bool serveFile(const HttpRequest& req, const std::string& path, HttpResponse* resp);
+
+    // 设置验证器并判断结果：返回 kPartial 时 *first / *last 为要发送的闭区间。
+    // 命中条件请求时已把响应设置为 304，返回 false
+    static bool prepare(const HttpRequest& req, const Validators& validators, size_t size,
+                        HttpResponse* resp, RangeStatus* status, size_t* first, size_t* last);
+
+    static bool notModified(const HttpRequest& req, const Validators& validators);
+    static RangeStatus parseRange(const HttpRequest& req, const Validators& validators, size_t size,
+                                  size_t* first, size_t* last);
+};
+
+} // namespace http
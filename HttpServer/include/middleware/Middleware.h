@@ -11,23 +11,22 @@ namespace middleware
 class Middleware 
 {
 public:
+    // before 的结果：继续交给后面的中间件和路由处理器，
+    // 或者响应已经写入 response，立即返回（如 CORS 预检请求、鉴权失败）
+    enum Result
+    {
+        kContinue,
+        kRespond,
+    };
+
     virtual ~Middleware() = default;
     
     // 请求前处理
-    virtual void before(HttpRequest& request) = 0;
-    
-    // 响应后处理
-    virtual void after(HttpResponse& response) = 0;
+    virtual Result before(HttpRequest& request, HttpResponse& response) = 0;
     
-    // 设置下一个中间件
-    void setNext(std::shared_ptr<Middleware> next) 
-    {
-        nextMiddleware_ = next;
-    }
-
-protected:
-    std::shared_ptr<Middleware> nextMiddleware_;
+    // 响应后处理：只对 before 返回了 kContinue 的中间件调用，顺序与 before 相反
+    virtual void after(const HttpRequest& request, HttpResponse& response) = 0;
 };
 
 } // namespace middleware
-} // namespace http
\ No newline at end of file
+} // namespace http
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <string_view>
 #include "Middleware.h"
 
 namespace http 
@@ -9,16 +11,32 @@ namespace http
 namespace middleware 
 {
 
+// 中间件链：中间件可以全局注册，也可以只挂在某个路径前缀上（"/api" 匹配 /api 和 /api/...）。
+// 按注册顺序调用 before，某个中间件返回 kRespond 时不再调用后续中间件和路由处理器，
+// 之前已经通过的中间件仍按相反顺序调用 after
 class MiddlewareChain 
 {
 public:
     void addMiddleware(std::shared_ptr<Middleware> middleware);
-    void processBefore(HttpRequest& request);
-    void processAfter(HttpResponse& response);
+    void addMiddleware(const std::string& prefix, std::shared_ptr<Middleware> middleware);
+
+    // 返回 false 表示已经生成响应，不需要再路由。*depth 交给 processAfter，记录需要调用 after 的范围
+    bool processBefore(HttpRequest& request, HttpResponse& response, size_t* depth);
+    void processAfter(const HttpRequest& request, HttpResponse& response, size_t depth);
+
+    bool empty() const { return middlewares_.empty(); }
 
 private:
-    std::vector<std::shared_ptr<Middleware>> middlewares_;
+    struct Entry
+    {
+        std::string                 prefix; // 为空时对所有请求生效
+        std::shared_ptr<Middleware> middleware;
+
+        bool matches(std::string_view path) const;
+    };
+
+    std::vector<Entry> middlewares_;
 };
 
 } // namespace middleware
-} // namespace http
\ No newline at end of file
+} // namespace http
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "Middleware.h"
+
+namespace http
+{
+namespace middleware
+{
+
+// 编译期组合的中间件流水线：各中间件按具体类型保存在 tuple 中，before / after 直接调用（可内联），
+// 整条流水线对外只是一个 Middleware，注册到 MiddlewareChain 后每个请求只有一次虚函数调用。
+// 中间件类型只需要提供与 Middleware 相同签名的 before / after，不必继承 Middleware。
+//
+//   httpServer.addMiddleware("/api", middleware::makePipeline(CorsMiddleware(), AuthMiddleware(...)));
+template <typename... Middlewares>
+class Pipeline : public Middleware
+{
+public:
+    static constexpr size_t kSize = sizeof...(Middlewares);
+
+    explicit Pipeline(Middlewares... middlewares)
+        : middlewares_(std::move(middlewares)...)
+    {}
+
+    Result before(HttpRequest& request, HttpResponse& response) override
+    {
+        return runBefore(request, response, std::index_sequence_for<Middlewares...>());
+    }
+
+    // 整条流水线的 before 都通过时才会被调用；中途直接响应时，已通过的中间件在 before 中反向调用 after
+    void after(const HttpRequest& request, HttpResponse& response) override
+    {
+        runAfter(request, response, std::index_sequence_for<Middlewares...>());
+    }
+
+    template <size_t I>
+    auto& get() { return std::get<I>(middlewares_); }
+
+private:
+    template <size_t... Is>
+    Result runBefore(HttpRequest& request, HttpResponse& response, std::index_sequence<Is...>)
+    {
+        size_t passed = 0;
+        // 短路求值：某个中间件返回 kRespond 后不再调用后面的中间件
+        bool respond = (... || (std::get<Is>(middlewares_).before(request, response) == kRespond ||
+                                (++passed, false)));
+        if (respond)
+        {
+            // 已通过的中间件仍需反向调用 after
+            runAfterUpTo(passed, request, response, std::index_sequence_for<Middlewares...>());
+            return kRespond;
+        }
+        return kContinue;
+    }
+
+    template <size_t... Is>
+    void runAfter(const HttpRequest& request, HttpResponse& response, std::index_sequence<Is...>)
+    {
+        (std::get<kSize - 1 - Is>(middlewares_).after(request, response), ...);
+    }
+
+    template <size_t... Is>
+    void runAfterUpTo(size_t passed, const HttpRequest& request, HttpResponse& response, std::index_sequence<Is...>)
+    {
+        ((kSize - 1 - Is < passed ? std::get<kSize - 1 - Is>(middlewares_).after(request, response) : void()), ...);
+    }
+
+private:
+    std::tuple<Middlewares...> middlewares_;
+};
+
+template <typename... Middlewares>
+std::shared_ptr<Pipeline<Middlewares...>> makePipeline(Middlewares... middlewares)
+{
+    return std::make_shared<Pipeline<Middlewares...>>(std::move(middlewares)...);
+}
+
+} // namespace middleware
+} // namespace http
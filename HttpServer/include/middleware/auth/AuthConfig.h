@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+namespace http
+{
+namespace middleware
+{
+
+struct AuthConfig
+{
+    // 会话中保存登录状态的字段
+    std::string userIdKey = "userId";       // 整数用户 id
+    std::string loggedInKey = "isLoggedIn"; // 值为 "true" 表示已登录
+    std::string roleKey = "role";           // "admin" 为管理员，其余已登录用户为普通用户
+
+    // 为 true 时未登录的请求直接返回 401，适合挂在路径前缀上保护整组路由；
+    // 为 false 时只解析身份，由路由的 authRequired 决定是否拒绝
+    bool required = false;
+
+    static AuthConfig defaultConfig()
+    {
+        return AuthConfig();
+    }
+};
+
+} // namespace middleware
+} // namespace http
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../Middleware.h"
+#include "../../http/AuthContext.h"
+#include "../../http/HttpRequest.h"
+#include "../../http/HttpResponse.h"
+#include "../../session/SessionManager.h"
+#include "AuthConfig.h"
+
+namespace http
+{
+namespace middleware
+{
+
+// 鉴权中间件：每个请求解析一次会话，把用户 id、登录状态和角色以 AuthContext 的形式挂到请求上，
+// 处理器通过 req.auth() 读取，路由通过 authRequired 声明需要登录（未登录时返回 401，不进入处理器）。
+// 没有会话 Cookie 的请求直接作为访客，不访问会话存储；
+// 解析出的会话绑定在请求上，处理器再调用 SessionManager::getSession 不会重复加载
+class AuthMiddleware final : public Middleware
+{
+public:
+    explicit AuthMiddleware(session::SessionManager* sessionManager,
+                            const AuthConfig& config = AuthConfig::defaultConfig());
+
+    // config.required 为 true 且未登录时生成 401 并返回 kRespond
+    Result before(HttpRequest& request, HttpResponse& response) override;
+    void after(const HttpRequest&, HttpResponse&) override {}
+
+    // 从会话中解析身份，字段缺失或格式不对时按未登录处理
+    AuthContext resolve(const session::Session& session) const;
+
+private:
+    session::SessionManager* sessionManager_;
+    AuthConfig               config_;
+};
+
+} // namespace middleware
+} // namespace http
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace http 
+{
+namespace middleware 
+{
+
+struct CompressionConfig 
+{
+    int gzipLevel = 6;       // 动态压缩的 gzip 级别（1 ~ 9）
+    int brotliQuality = 5;   // 动态压缩的 brotli 质量（0 ~ 11）
+    bool enableBrotli = true;
+    size_t minSize = 1024;   // 小于该长度的响应体不压缩，省下的字节抵不过压缩开销
+    
+    static CompressionConfig defaultConfig() 
+    {
+        return CompressionConfig();
+    }
+};
+
+} // namespace middleware
+} // namespace http
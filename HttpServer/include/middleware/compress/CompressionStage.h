@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string_view>
+
+#include "../../http/HttpRequest.h"
+#include "../../http/HttpResponse.h"
+#include "CompressionConfig.h"
+
+namespace http 
+{
+namespace middleware 
+{
+
+// 响应压缩：在 MiddlewareChain::processAfter 之后执行（需要同时看到请求的 Accept-Encoding 和最终的响应体，
+// 而 Middleware::after 拿不到请求，所以不做成中间件）。
+//  - 只处理 200、没有 Content-Encoding、内容类型值得压缩且不小于 minSize 的响应；
+//  - 按 Accept-Encoding（含 q 值）协商出候选编码，q 值相同时 br 在 gzip 之前；
+//  - 响应带有预压缩版本（静态资源缓存）时按候选顺序选用第一个存在的版本（没有 br 版本时用 gzip 版本），
+//    否则按配置的级别现场压缩；文件响应体（分块读取发送）不做现场压缩；
+//  - 压缩后 ETag 改为弱 ETag；值得压缩的 200 和 304 响应都加上 Vary: Accept-Encoding，
+//    304 更新缓存的响应头时不会丢掉 Vary
+class CompressionStage 
+{
+public:
+    enum Encoding
+    {
+        kIdentity,
+        kGzip,
+        kBrotli,
+    };
+
+    explicit CompressionStage(const CompressionConfig& config = CompressionConfig::defaultConfig());
+
+    void process(const HttpRequest& request, HttpResponse& response) const;
+
+    // 客户端可以接受的编码，按优先顺序排列，不含 identity
+    struct Preference
+    {
+        Encoding encodings[2];
+        size_t   count = 0;
+    };
+
+    // 根据 Accept-Encoding 排列候选编码
+    Preference negotiate(std::string_view acceptEncoding) const;
+
+private:
+    CompressionConfig config_;
+};
+
+} // namespace middleware
+} // namespace http
@@ -10,9 +10,14 @@ namespace middleware
 
 struct CorsConfig 
 {
+    // "*" 允许任意源；也可以是完整的源（"https://example.com"）
+    // 或带一个通配符的模式（"https://*.example.com" 匹配该域名的任意子域）；
+    // 为空时与 {"*"} 相同，允许任意源
     std::vector<std::string> allowedOrigins;
     std::vector<std::string> allowedMethods;
     std::vector<std::string> allowedHeaders;
+    // 允许带凭据（Cookie）的跨源请求时，allowedOrigins 必须显式列出源（不能为空或包含 "*"），
+    // 否则构造 CorsMiddleware 时 LOG_FATAL
     bool allowCredentials = false;
     int maxAge = 3600;
     
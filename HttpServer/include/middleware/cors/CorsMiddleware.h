@@ -1,5 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include "../Middleware.h"
 #include "../../http/HttpRequest.h"
 #include "../../http/HttpResponse.h"
@@ -10,24 +16,53 @@ namespace http
 namespace middleware 
 {
 
-class CorsMiddleware : public Middleware 
+// 构造时把配置编译成可以直接写入响应的头部字节：
+//  - 每个精确匹配的源一块 "Access-Control-Allow-Origin: <源>\r\n[Access-Control-Allow-Credentials: true\r\n]"，
+//    放在哈希表中按请求的 Origin 查找；通配模式（https://*.example.com）按前后缀匹配；
+//  - 预检响应额外的 Allow-Methods / Allow-Headers / Max-Age 拼成一块。
+// 允许任意源且不带凭据时响应 "*"，与 Origin 无关；否则回显请求的 Origin，并加上 Vary: Origin，
+// 保证下游缓存按 Origin 区分（包括没有匹配、没有加 CORS 头的响应）。
+// 头部字节由中间件持有，响应只保存引用，中间件需要在服务器运行期间一直存在
+class CorsMiddleware final : public Middleware 
 {
 public:
     explicit CorsMiddleware(const CorsConfig& config = CorsConfig::defaultConfig());
     
-    void before(HttpRequest& request) override;
-    void after(HttpResponse& response) override;
+    // 预检请求（OPTIONS）直接在 response 中生成 204 / 403 并返回 kRespond
+    Result before(HttpRequest& request, HttpResponse& response) override;
+    void after(const HttpRequest& request, HttpResponse& response) override;
 
-    std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
+    static std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
 
 private:
-    bool isOriginAllowed(const std::string& origin) const;
-    void handlePreflightRequest(const HttpRequest& request, HttpResponse& response);
-    void addCorsHeaders(HttpResponse& response, const std::string& origin);
+    // 加上允许 origin 的头部，不允许时返回 false
+    bool addCorsHeaders(std::string_view origin, HttpResponse& response) const;
+    bool matchesPattern(std::string_view origin) const;
+    void handlePreflightRequest(const HttpRequest& request, HttpResponse& response) const;
 
 private:
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+    };
+
+    struct OriginPattern
+    {
+        std::string prefix; // "https://"
+        std::string suffix; // ".example.com"
+    };
+
     CorsConfig config_;
+    bool       anyOrigin_; // 配置了 "*" 或没有配置源
+    bool       varyOrigin_; // 响应头随 Origin 变化，需要 Vary: Origin
+    // 精确匹配的源 -> 预先生成的头部
+    std::unordered_map<std::string, std::string, StringHash, std::equal_to<>> originHeaders_;
+    std::vector<OriginPattern> patterns_;
+    std::string wildcardHeaders_; // "Access-Control-Allow-Origin: *\r\n"
+    std::string credentialsHeader_; // 回显 Origin 时附加的 Allow-Credentials，可能为空
+    std::string preflightHeaders_; // 预检响应的 Allow-Methods / Allow-Headers / Max-Age
 };
 
 } // namespace middleware
-} // namespace http
\ No newline at end of file
+} // namespace http
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../async/Task.h"
+#include "../http/HttpRequest.h"
+#include "../http/HttpResponse.h"
+
+namespace http
+{
+namespace router
+{
+
+// 协程式路由处理器：handle 中可以 co_await 数据库查询、工作线程池（async::runInPool）和定时器（async::sleepFor），
+// 等待期间不占用 IO 线程，结束后在连接所属的 IO 线程发送响应。
+// req 和 resp 由 HttpServer 持有，在返回的 Task 结束之前一直有效
+class AsyncRouterHandler
+{
+public:
+    virtual ~AsyncRouterHandler() = default;
+    virtual async::Task<> handle(const HttpRequest& req, HttpResponse* resp) = 0;
+};
+
+} // namespace router
+} // namespace http
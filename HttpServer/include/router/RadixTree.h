@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../http/HttpRequest.h"
+
+namespace http
+{
+namespace router
+{
+
+// 压缩前缀树（radix tree），一个请求方法一棵。路由模式由三种片段组成：
+//  - 静态片段：/menu、/aiBot/start；公共前缀合并到同一个节点；
+//  - 参数 :name：匹配一个非空的路径段（到下一个 '/' 为止）；
+//  - 通配 *name（或 *）：只能出现在末尾，匹配剩下的全部路径（可以为空）。
+// 匹配时同一位置按 静态 > 参数 > 通配 的优先级尝试，失败时回溯；
+// 同一节点的静态子节点按其下的路由数排序，路由多的分支先比较
+class RadixTree
+{
+public:
+    static constexpr int kNoValue = -1;
+
+    RadixTree();
+    ~RadixTree();
+
+    // 插入模式，成功时返回已有或新建的值槽位（初始为 kNoValue）；
+    // 模式非法（通配不在末尾、同一位置的参数名不同）时返回 nullptr
+    int* insert(std::string_view pattern);
+
+    // 查找路径，匹配到时返回值并把参数写入 params（名字引用树中的字符串，值引用 path）；没有匹配返回 kNoValue
+    int match(std::string_view path, PathParams* params) const;
+
+private:
+    struct Node;
+
+    // 沿途经过、拆分出和新建的节点依次追加到 visited，插入新路由后统一更新它们的优先级
+    static Node* insertStatic(Node* node, std::string_view segment, std::vector<Node*>* visited);
+    static bool match(const Node* node, std::string_view path, PathParams* params, int* value);
+    static void sortChildren(Node* node);
+
+private:
+    std::unique_ptr<Node> root_;
+};
+
+} // namespace router
+} // namespace http
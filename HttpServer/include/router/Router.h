@@ -1,12 +1,13 @@
 #pragma once
-#include <iostream>
-#include <unordered_map>
-#include <string>
-#include <memory>
+#include <array>
 #include <functional>
-#include <regex>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "AsyncRouterHandler.h"
+#include "RadixTree.h"
 #include "RouterHandler.h"
 #include "../http/HttpRequest.h"
 #include "../http/HttpResponse.h"
@@ -19,38 +20,30 @@ namespace router
 // 选择注册对象式的路由处理器还是注册回调函数式的处理器取决于处理器执行的复杂程度
 // 如果是简单的处理可以注册回调函数，否则注册对象式路由处理器(对象中可封装多个相关函数)
 // 二者注册其一即可
+//
+// 路径可以是静态路径（/menu），也可以带参数（/user/:id）或通配（/static/*filepath），
+// 每个请求方法一棵压缩前缀树（RadixTree），匹配时不分配内存，参数写入 HttpRequest::pathParams()
 class Router
 {
 public:
     using HandlerPtr = std::shared_ptr<RouterHandler>;
     using HandlerCallback = std::function<void(const HttpRequest &, HttpResponse *)>;
+    using AsyncHandlerPtr = std::shared_ptr<AsyncRouterHandler>;
+    using AsyncCallback = std::function<async::Task<>(const HttpRequest &, HttpResponse *)>;
 
-    // 路由键（请求方法 + URI）
-    struct RouteKey
+    // 一条路由：处理器（三种形式之一）和路由级别的选项
+    struct Route
     {
-        HttpRequest::Method method;
-        std::string path;
-
-        bool operator==(const RouteKey &other) const
-        {
-            return method == other.method && path == other.path;
-        }
-    };
-
-    // 为RouteKey 定义哈希函数
-    struct RouteKeyHash
-    {
-        // size_t operator()(const RouteKey& key) const
-        // {
-        //     return std::hash<int>{}(static_cast<int>(key.method)) ^
-        //            std::hash<std::string>{}(key.path);
-        // }
-        size_t operator()(const RouteKey &key) const
-        {
-            size_t methodHash = std::hash<int>{}(static_cast<int>(key.method));
-            size_t pathHash = std::hash<std::string>{}(key.path);
-            return methodHash * 31 + pathHash;
-        }
+        std::string     pattern;
+        HandlerPtr      handler;
+        HandlerCallback callback;
+        AsyncCallback   asyncCallback; // 协程式处理器，由 HttpServer 启动协程并在结束后发送响应
+        std::string     cacheControl; // 处理器成功返回（200 / 206 / 304）且没有自己设置时附加
+        bool            blocking = false; // 在工作线程池中执行
+        bool            authRequired = false; // 需要登录（req.auth().loggedIn），否则返回 401，不进入处理器
+
+        bool hasHandler() const
+        { return handler || callback || asyncCallback; }
     };
 
     // 注册路由处理器
@@ -59,65 +52,69 @@ public:
     // 注册回调函数形式的处理器
     void registerCallback(HttpRequest::Method method, const std::string &path, const HandlerCallback &callback);
 
-    // 注册动态路由处理器
-    void addRegexHandler(HttpRequest::Method method, const std::string &path, HandlerPtr handler)
+    // 注册协程式处理器
+    void registerAsyncHandler(HttpRequest::Method method, const std::string &path, AsyncHandlerPtr handler)
     {
-        std::regex pathRegex = convertToRegex(path);
-        regexHandlers_.emplace_back(method, pathRegex, handler);
+        registerAsyncCallback(method, path, [handler](const HttpRequest &req, HttpResponse *resp) {
+            return handler->handle(req, resp);
+        });
     }
 
-    // 注册动态路由处理函数
-    void addRegexCallback(HttpRequest::Method method, const std::string &path, const HandlerCallback &callback)
-    {
-        std::regex pathRegex = convertToRegex(path);
-        regexCallbacks_.emplace_back(method, pathRegex, callback);
-    }
+    void registerAsyncCallback(HttpRequest::Method method, const std::string &path, const AsyncCallback &callback);
+
+    // 为路由设置 Cache-Control（如 "no-cache"、"public, max-age=3600"）
+    void setCacheControl(HttpRequest::Method method, const std::string &path, const std::string &value);
+
+    // 标记路由会阻塞（访问数据库、耗时计算），由 HttpServer 投递到工作线程池执行
+    void setBlocking(HttpRequest::Method method, const std::string &path);
+
+    // 标记路由需要登录。身份由 AuthMiddleware 解析，没有注册该中间件时所有请求都按未登录处理
+    void setAuthRequired(HttpRequest::Method method, const std::string &path);
+
+    // 查找请求对应的路由并设置路径参数，没有则返回空
+    const Route *match(HttpRequest &req) const;
 
     // 处理请求
-    bool route(const HttpRequest &req, HttpResponse *resp);
+    bool route(HttpRequest &req, HttpResponse *resp);
 
-private:
-    std::regex convertToRegex(const std::string &pathPattern)
-    { // 将路径模式转换为正则表达式，支持匹配任意路径参数
-        std::string regexPattern = "^" + std::regex_replace(pathPattern, std::regex(R"(/:([^/]+))"), R"(/([^/]+))") + "$";
-        return std::regex(regexPattern);
+    // 附加路由的 Cache-Control（协程式处理器结束后由 HttpServer 调用）
+    static void applyCacheControl(const Route &route, HttpResponse *resp)
+    {
+        applyCacheControl(route.cacheControl, resp);
     }
 
-    // 提取路径参数
-    void extractPathParameters(const std::smatch &match, HttpRequest &request)
+    static void applyCacheControl(std::string_view cacheControl, HttpResponse *resp);
+
+    // 需要登录的路由检查身份，未登录时写入 401 并返回 false（协程式处理器由 HttpServer 调用）
+    static bool authorize(const Route &route, const HttpRequest &req, HttpResponse *resp)
     {
-        // Assuming the first match is the full path, parameters start from index 1
-        for (size_t i = 1; i < match.size(); ++i)
+        if (route.authRequired && !req.auth().loggedIn)
         {
-            request.setPathParameters("param" + std::to_string(i), match[i].str());
+            respondUnauthorized(req, resp);
+            return false;
         }
+        return true;
     }
 
+    // 统一的 401 响应，响应体是共享的常量，不拷贝
+    static void respondUnauthorized(const HttpRequest &req, HttpResponse *resp);
+
 private:
-    struct RouteCallbackObj
-    {
-        HttpRequest::Method method_;
-        std::regex pathRegex_;
-        HandlerCallback callback_;
-        RouteCallbackObj(HttpRequest::Method method, std::regex pathRegex, const HandlerCallback &callback)
-            : method_(method), pathRegex_(pathRegex), callback_(callback) {}
-    };
+    // 找到或创建 pattern 对应的路由，模式非法时返回空
+    Route *addRoute(HttpRequest::Method method, const std::string &pattern);
 
-    struct RouteHandlerObj
-    {
-        HttpRequest::Method method_;
-        std::regex pathRegex_;
-        HandlerPtr handler_;
-        RouteHandlerObj(HttpRequest::Method method, std::regex pathRegex, HandlerPtr handler)
-            : method_(method), pathRegex_(pathRegex), handler_(handler) {}
-    };
+    const Route *find(HttpRequest::Method method, std::string_view path, PathParams *params) const;
+
+    // 调用对象式处理器（区分普通请求和流式请求体）
+    static void dispatch(const HandlerPtr &handler, const HttpRequest &req, HttpResponse *resp);
+
+private:
+    static constexpr size_t kMethodCount = HttpRequest::kOptions + 1;
 
-    std::unordered_map<RouteKey, HandlerPtr, RouteKeyHash>      handlers_;       // 精准匹配
-    std::unordered_map<RouteKey, HandlerCallback, RouteKeyHash> callbacks_; // 精准匹配
-    std::vector<RouteHandlerObj>                                regexHandlers_;     // 正则匹配
-    std::vector<RouteCallbackObj>                               regexCallbacks_;   // 正则匹配
+    std::array<RadixTree, kMethodCount> trees_; // 每个请求方法一棵树，值为 routes_ 的下标
+    std::vector<std::unique_ptr<Route>> routes_;
 };
 
 
 } // namespace router
-} // namespace http
\ No newline at end of file
+} // namespace http
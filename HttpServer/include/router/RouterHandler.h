@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <memory>
 #include "../http/HttpRequest.h"
 #include "../http/HttpResponse.h"
@@ -14,6 +15,14 @@ class RouterHandler
 public:
     virtual ~RouterHandler() = default;
     virtual void handle(const HttpRequest& req, HttpResponse* resp) = 0;
+
+    // 流式接收请求体（可选）：返回 true 时请求体不再整体缓存，
+    // 而是每到达一段就调用 onBodyChunk，全部到达后调用 onBodyEnd 生成响应。
+    // 前置中间件和登录检查在请求头到达时就已执行，被拒绝的请求不会交付任何数据，
+    // onBodyChunk 中可以通过 req.auth() 取得当前用户
+    virtual bool streamBody() const { return false; }
+    virtual void onBodyChunk(const HttpRequest&, std::string_view) {}
+    virtual void onBodyEnd(const HttpRequest& req, HttpResponse* resp) { handle(req, resp); }
 };
 
 } // namespace router
@@ -0,0 +1,329 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "Router.h"
+#include "../http/HttpRequest.h"
+#include "../http/HttpResponse.h"
+
+namespace http
+{
+namespace router
+{
+
+// 编译期静态路由表：路由集合在编译时已知（方法 + 静态路径），
+// 编译期为它生成最小完美哈希（hash-and-displace），运行时只对路径做一次 FNV-1a，
+// 查两次表、比较一次字符串即可定位路由；处理器以具体类型保存在 tuple 中直接调用，
+// 没有 std::function / shared_ptr 的类型擦除和虚函数调用。
+//
+// 用法：
+//   auto routes = http::router::makeStaticRouter(
+//       http::router::get<"/menu">(MenuHandler(server)).cacheControl("no-store"),
+//       http::router::post<"/user/logout">([](const HttpRequest& req, HttpResponse* resp) { ... }));
+//   httpServer.setStaticRouter(std::move(routes));
+//
+// 只支持静态路径；带参数、通配、协程式或阻塞的路由仍注册到动态 Router，
+// HttpServer 先查静态路由表，没有命中再交给 Router。
+
+// 可以作为模板参数的字符串字面量
+template <size_t N>
+struct FixedString
+{
+    char data[N] = {};
+
+    constexpr FixedString(const char (&str)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            data[i] = str[i];
+        }
+    }
+
+    constexpr std::string_view view() const
+    { return std::string_view(data, N - 1); }
+};
+
+namespace detail
+{
+
+// FNV-1a（64 位），方法作为第一个字节参与哈希
+constexpr uint64_t routeHash(HttpRequest::Method method, std::string_view path)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<uint64_t>(method)) * 1099511628211ULL;
+    for (char c : path)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 第二级哈希：用每个桶的种子重新打散（splitmix64 的混合函数）
+constexpr uint64_t slotHash(uint64_t hash, uint32_t seed)
+{
+    uint64_t z = hash ^ (static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+constexpr size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t size = 1;
+    while (size < n)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+struct RouteKey
+{
+    HttpRequest::Method method;
+    std::string_view    path;
+};
+
+// 完美哈希表：bucket = hash & (kBuckets - 1)，slot = slotHash(hash, seeds[bucket]) & (kSlots - 1)，
+// slots[slot] 为路由下标（-1 表示空）
+template <size_t N>
+struct PerfectHashTable
+{
+    static constexpr size_t kBuckets = roundUpPowerOfTwo(N);
+    static constexpr size_t kSlots = roundUpPowerOfTwo(2 * N);
+
+    std::array<uint32_t, kBuckets> seeds = {};
+    std::array<int, kSlots>        slots = {};
+};
+
+// 编译期构造：先放键最多的桶，逐个尝试种子直到桶内的键都落在空槽位上。
+// 路由重复或找不到种子时抛出异常，在常量求值中表现为编译错误
+template <size_t N>
+constexpr PerfectHashTable<N> buildPerfectHash(const std::array<RouteKey, N>& keys)
+{
+    using Table = PerfectHashTable<N>;
+    Table table;
+    for (int& slot : table.slots)
+    {
+        slot = -1;
+    }
+
+    std::array<uint64_t, N> hashes = {};
+    std::array<size_t, Table::kBuckets> bucketSize = {};
+    size_t maxBucketSize = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (keys[j].method == keys[i].method && keys[j].path == keys[i].path)
+            {
+                throw "duplicate static route";
+            }
+        }
+        hashes[i] = routeHash(keys[i].method, keys[i].path);
+        size_t size = ++bucketSize[hashes[i] & (Table::kBuckets - 1)];
+        maxBucketSize = size > maxBucketSize ? size : maxBucketSize;
+    }
+
+    for (size_t size = maxBucketSize; size > 0; --size)
+    {
+        for (size_t bucket = 0; bucket < Table::kBuckets; ++bucket)
+        {
+            if (bucketSize[bucket] != size)
+            {
+                continue;
+            }
+
+            std::array<size_t, N> members = {};
+            size_t count = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if ((hashes[i] & (Table::kBuckets - 1)) == bucket)
+                {
+                    members[count++] = i;
+                }
+            }
+
+            bool placed = false;
+            for (uint32_t seed = 0; seed < (1u << 16) && !placed; ++seed)
+            {
+                std::array<size_t, N> chosen = {};
+                placed = true;
+                for (size_t m = 0; m < count && placed; ++m)
+                {
+                    chosen[m] = slotHash(hashes[members[m]], seed) & (Table::kSlots - 1);
+                    placed = table.slots[chosen[m]] < 0;
+                    for (size_t k = 0; k < m && placed; ++k)
+                    {
+                        placed = chosen[k] != chosen[m];
+                    }
+                }
+                if (placed)
+                {
+                    table.seeds[bucket] = seed;
+                    for (size_t m = 0; m < count; ++m)
+                    {
+                        table.slots[chosen[m]] = static_cast<int>(members[m]);
+                    }
+                }
+            }
+            if (!placed)
+            {
+                throw "no perfect hash for static routes";
+            }
+        }
+    }
+    return table;
+}
+
+template <typename Handler>
+concept ObjectHandler = requires(Handler& handler, const HttpRequest& req, HttpResponse* resp)
+{
+    handler.handle(req, resp);
+};
+
+} // namespace detail
+
+// 一条静态路由：方法和路径编码在类型里，处理器保存具体类型。
+// Handler 可以是带 handle(req, resp) 的对象（如 RouterHandler 的子类，直接按具体类型调用），
+// 也可以是任意 void(const HttpRequest&, HttpResponse*) 的可调用对象
+template <HttpRequest::Method M, FixedString Path, typename Handler>
+class StaticRoute
+{
+public:
+    static constexpr HttpRequest::Method kMethod = M;
+    static constexpr std::string_view    kPath = Path.view();
+
+    static_assert(!kPath.empty() && kPath[0] == '/', "static route path must start with '/'");
+
+    explicit StaticRoute(Handler handler)
+        : handler_(std::move(handler))
+    {}
+
+    // 处理器成功返回（200 / 206 / 304）且没有自己设置时附加的 Cache-Control
+    StaticRoute&& cacheControl(std::string value) &&
+    {
+        cacheControl_ = std::move(value);
+        return std::move(*this);
+    }
+
+    // 需要登录，未登录时返回 401，不进入处理器
+    StaticRoute&& requireAuth() &&
+    {
+        authRequired_ = true;
+        return std::move(*this);
+    }
+
+    void operator()(const HttpRequest& req, HttpResponse* resp)
+    {
+        if (authRequired_ && !req.auth().loggedIn)
+        {
+            Router::respondUnauthorized(req, resp);
+            return;
+        }
+        if constexpr (detail::ObjectHandler<Handler>)
+        {
+            handler_.handle(req, resp);
+        }
+        else
+        {
+            handler_(req, resp);
+        }
+        Router::applyCacheControl(cacheControl_, resp);
+    }
+
+private:
+    Handler     handler_;
+    std::string cacheControl_;
+    bool        authRequired_ = false;
+};
+
+template <FixedString Path, typename Handler>
+StaticRoute<HttpRequest::kGet, Path, Handler> get(Handler handler)
+{
+    return StaticRoute<HttpRequest::kGet, Path, Handler>(std::move(handler));
+}
+
+template <FixedString Path, typename Handler>
+StaticRoute<HttpRequest::kPost, Path, Handler> post(Handler handler)
+{
+    return StaticRoute<HttpRequest::kPost, Path, Handler>(std::move(handler));
+}
+
+template <HttpRequest::Method M, FixedString Path, typename Handler>
+StaticRoute<M, Path, Handler> route(Handler handler)
+{
+    return StaticRoute<M, Path, Handler>(std::move(handler));
+}
+
+template <typename... Routes>
+class StaticRouter
+{
+public:
+    static constexpr size_t kRouteCount = sizeof...(Routes);
+
+    static_assert(kRouteCount > 0, "static router needs at least one route");
+
+    explicit StaticRouter(Routes... routes)
+        : routes_(std::move(routes)...)
+    {}
+
+    // 返回路由下标，没有匹配时返回 -1；可以在编译期求值
+    static constexpr int find(HttpRequest::Method method, std::string_view path)
+    {
+        uint64_t hash = detail::routeHash(method, path);
+        uint32_t seed = kTable.seeds[hash & (Table::kBuckets - 1)];
+        int index = kTable.slots[detail::slotHash(hash, seed) & (Table::kSlots - 1)];
+        if (index < 0 || kKeys[index].method != method || kKeys[index].path != path)
+        {
+            return -1;
+        }
+        return index;
+    }
+
+    // 处理请求，没有匹配的静态路由时返回 false
+    bool route(const HttpRequest& req, HttpResponse* resp)
+    {
+        int index = find(req.method(), req.pathView());
+        if (index < 0)
+        {
+            return false;
+        }
+        invoke(index, req, resp, std::index_sequence_for<Routes...>());
+        return true;
+    }
+
+    bool operator()(const HttpRequest& req, HttpResponse* resp)
+    {
+        return route(req, resp);
+    }
+
+private:
+    using Table = detail::PerfectHashTable<kRouteCount>;
+
+    // 按下标分派到具体类型的处理器，编译器展开为比较链或跳转表
+    template <size_t... Is>
+    void invoke(int index, const HttpRequest& req, HttpResponse* resp, std::index_sequence<Is...>)
+    {
+        (void)((static_cast<int>(Is) == index ? (std::get<Is>(routes_)(req, resp), true) : false) || ...);
+    }
+
+private:
+    static constexpr std::array<detail::RouteKey, kRouteCount> kKeys = {{ { Routes::kMethod, Routes::kPath }... }};
+    static constexpr Table kTable = detail::buildPerfectHash(kKeys);
+
+    std::tuple<Routes...> routes_;
+};
+
+template <typename... Routes>
+StaticRouter<Routes...> makeStaticRouter(Routes... routes)
+{
+    return StaticRouter<Routes...>(std::move(routes)...);
+}
+
+} // namespace router
+} // namespace http
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SessionStorage.h"
+
+namespace http
+{
+namespace session
+{
+
+// 无状态的会话存储：会话数据（id、过期时间和各字段）编码进 Cookie，用 HMAC-SHA256 签名，
+// 可选 AES-256-GCM 加密（先加密后签名）。服务端不保存任何会话状态，
+// 任何线程、任何一台服务器只要持有相同的密钥就能验证会话，多实例部署时不需要粘性会话。
+//
+// Cookie 格式：<模式>.<密钥 id>.<base64url(数据)>.<base64url(HMAC)>，模式 "v1" 为明文，"e1" 为加密。
+// 密钥轮换：第一个密钥用于签发，其余密钥只用于验证，旧 Cookie 续签时自动换成新密钥。
+// 签名和加密使用从密钥派生出的两个子密钥。
+//
+// 限制：Cookie 不宜超过 4KB，只适合保存少量字段；会话无法在服务端撤销，
+// destroySession 只能让浏览器删除 Cookie，需要撤销时应缩短 maxAge 或轮换密钥
+class CookieSessionStorage : public SessionStorage
+{
+public:
+    struct Key
+    {
+        std::string id;     // 写入 Cookie 的短标识，不能包含 '.'
+        std::string secret; // 至少 32 字节的随机数据
+    };
+
+    // keys 的第一个密钥用于签发；encrypt 为 true 时会话内容对客户端不可见
+    explicit CookieSessionStorage(const std::vector<Key>& keys, bool encrypt = false);
+
+    // 会话数据都在 Cookie 中，save / remove 不需要做任何事
+    void save(std::shared_ptr<Session>) override {}
+    void remove(const std::string&) override {}
+
+    // 验证并解码 Cookie，签名不对、无法解密或已过期时返回空
+    std::shared_ptr<Session> load(const std::string& cookie) override;
+
+    // 剩余有效期不足一半时续签
+    bool touch(const std::shared_ptr<Session>& session) override;
+
+    std::string cookieValue(const Session& session) override;
+    bool storesInCookie() const override { return true; }
+
+private:
+    struct DerivedKey
+    {
+        std::string id;
+        std::string signKey;
+        std::string encryptKey;
+    };
+
+    const DerivedKey* findKey(std::string_view id) const;
+    static std::string sign(const DerivedKey& key, std::string_view data);
+    static bool encrypt(const DerivedKey& key, const std::string& plain, std::string* out);
+    static bool decrypt(const DerivedKey& key, std::string_view sealed, std::string* out);
+
+private:
+    std::vector<DerivedKey> keys_;
+    bool                    encrypt_;
+};
+
+} // namespace session
+} // namespace http
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SessionStorage.h"
+
+namespace http
+{
+namespace session
+{
+
+// 持久化的会话存储：会话保存在内存映射的文件中，进程重启（发布新版本）后会话仍然有效。
+//
+// 文件由定长槽组成，第 0 个槽是文件头。一条会话记录占一个头槽，放不下时接若干溢出槽（链表），
+// 记录的 CRC32、序号、长度和过期时间保存在头槽中。写入时总是先写到空闲槽，最后写头槽的状态字，
+// 再释放旧记录（写时复制）：进程在任意位置崩溃，旧记录或新记录至少有一条是完整的，
+// 启动时同一个会话有两条记录则保留校验通过、序号大的一条。过期时间不参与校验，touch 时原地更新。
+//
+// 热启动只顺序扫描一遍槽头，把头槽号放进开放寻址的索引（会话 id 直接和文件中的 id 比较，
+// 不为每个会话分配内存），会话内容和 CRC 在第一次 load 时才解码、校验，
+// 百万个会话的文件也能在几百毫秒内完成启动。
+// 数据写入页缓存即对之后的进程可见，进程崩溃不会丢失；removeExpired 每次调用时异步刷盘（msync），
+// 机器掉电最多丢失最近一两秒的修改。
+//
+// 和 ShardedSessionStorage 一样按会话 id 的哈希分片，每个分片一把锁、一张索引；
+// 一条记录占用的槽只由所属分片读写，只有分配、释放槽（空闲表、扩容）才短暂地持有一把全局锁。
+// 启动时预留一段固定的地址空间，文件扩容时在原地址上重新映射，已有槽的地址不变，其他分片读写不受影响。
+// 文件打不开、被其他进程锁住超过 lockTimeoutSeconds 时 LOG_FATAL，不会悄悄退化成不持久化的存储
+class MmapSessionStorage : public SessionStorage
+{
+public:
+    struct Stats
+    {
+        size_t   sessions = 0;        // 索引中的会话数
+        size_t   loaded = 0;          // 其中已经解码到内存中的会话数
+        size_t   unpersisted = 0;     // 写入文件失败、只在内存中的会话数
+        size_t   slots = 0;           // 文件中的槽数（不含文件头）
+        size_t   freeSlots = 0;       // 空闲槽数
+        uint64_t overflowRecords = 0; // 使用了溢出槽的记录写入次数
+    };
+
+    // slotSize 只在新建文件时使用，已有的文件沿用文件头中的槽大小；
+    // 文件被其他进程（滚动发布时的旧进程）锁住时最多等待 lockTimeoutSeconds 秒；
+    // 分片数向上取整为 2 的幂，最多 256 个
+    explicit MmapSessionStorage(const std::string& path, size_t slotSize = 256, size_t initialSlots = 4096,
+                                double lockTimeoutSeconds = 30, size_t shardCount = 16);
+    ~MmapSessionStorage() override;
+
+    MmapSessionStorage(const MmapSessionStorage&) = delete;
+    MmapSessionStorage& operator=(const MmapSessionStorage&) = delete;
+
+    void save(std::shared_ptr<Session> session) override;
+    std::shared_ptr<Session> load(const std::string& sessionId) override;
+    void remove(const std::string& sessionId) override;
+
+    // 原地更新文件中的过期时间
+    bool touch(const std::shared_ptr<Session>& session) override;
+
+    // 异步刷盘，并在每个分片中检查一段索引、清理过期会话（每秒调用一次时约一分钟扫完一遍）；
+    // 每次只持有一个分片的锁，检查的项数有上限
+    void removeExpired() override;
+
+    Stats stats() const;
+    size_t shardCount() const { return shards_.size(); }
+
+private:
+    struct SlotHeader;
+
+    // 索引项：slot 为 0（文件头）表示空位，为 kNoSlot 表示会话写入文件失败、只在内存中（session 不为空）
+    struct IndexEntry
+    {
+        uint32_t                 slot;    // 记录的头槽号
+        uint32_t                 hash;    // 会话 id 的哈希，决定索引中的起始位置
+        std::shared_ptr<Session> session; // 第一次 load 之前为空
+    };
+
+    // 每个分片独占缓存行，避免不同分片的锁伪共享
+    struct alignas(64) Shard
+    {
+        std::mutex              mutex;
+        std::vector<IndexEntry> index;           // 大小为 2 的幂
+        size_t                  size = 0;
+        size_t                  loaded = 0;
+        size_t                  unpersisted = 0;
+        size_t                  cursor = 0;      // removeExpired 下一次开始检查的位置
+    };
+
+    bool open(size_t slotSize, size_t initialSlots, double lockTimeoutSeconds);
+    bool lockFile(double timeoutSeconds);
+    bool mapFile(size_t offset, size_t length, bool populate);
+    uint32_t alignedSlotCount(uint64_t count) const;
+    void recover();
+    bool grow(size_t minFree);
+    bool allocate(size_t size);
+
+    SlotHeader* slotAt(uint32_t index) const;
+    std::string_view idAt(uint32_t head) const;
+    size_t capacity() const;
+    uint32_t writeRecord(const std::string& sessionId, const std::string& payload, int64_t expiry);
+    bool readRecord(uint32_t head, std::string* data, std::vector<uint32_t>* slots) const;
+    void freeRecord(uint32_t head);
+    std::shared_ptr<Session> decode(uint32_t head) const;
+
+    Shard& shardFor(uint32_t hash) const;
+    std::string_view idOf(const IndexEntry& entry) const;
+    bool expired(const IndexEntry& entry, int64_t now) const;
+
+    // 线性探测的开放寻址索引，删除时后移填补空位，不留墓碑。调用方持有分片的锁
+    size_t find(const Shard& shard, std::string_view sessionId, uint32_t hash) const;
+    void insert(Shard& shard, uint32_t slot, uint32_t hash, std::shared_ptr<Session> session);
+    void erase(Shard& shard, size_t pos);
+    static void rehash(Shard& shard, size_t size);
+
+    static size_t slotSizeFor(size_t requested);
+    static uint32_t hashOf(std::string_view sessionId);
+    static int64_t expirySeconds(const Session& session);
+    static int64_t nowSeconds();
+
+private:
+    std::string                         path_;
+    int                                 fd_;
+    char*                               base_;        // 预留地址空间的起点，扩容时不变
+    size_t                              reservedSize_;
+    size_t                              slotSize_;
+    std::atomic<uint32_t>               slotCount_;   // 含文件头
+    std::atomic<uint64_t>               nextSeq_;
+    std::atomic<uint64_t>               overflowRecords_;
+    mutable std::mutex                  allocMutex_;  // 保护空闲表和扩容
+    std::vector<uint32_t>               freeSlots_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t                              shardMask_;
+};
+
+} // namespace session
+} // namespace http
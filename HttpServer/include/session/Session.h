@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 
 namespace http
@@ -13,6 +17,8 @@ namespace session
 
 class SessionManager;
 
+// 会话由存储共享：同一个会话的并发请求（IO 线程、工作线程池、协程）拿到的是同一个对象，
+// 因此字段和脏标记由互斥锁保护，其余状态是原子变量
 class Session : public std::enable_shared_from_this<Session>
 {
 public:
@@ -24,23 +30,77 @@ public:
     bool isExpired() const;
     void refresh(); // 刷新过期时间
 
+    std::chrono::system_clock::time_point expiryTime() const
+    {
+        return std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(expiryTime_.load(std::memory_order_relaxed)));
+    }
+
+    int maxAge() const
+    { return maxAge_; }
+
+    // 存储中记录的过期时间（如 Cookie 会话签发时写入的过期时间），用来判断是否需要续签
+    std::chrono::system_clock::time_point storedExpiry() const
+    {
+        return std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(storedExpiry_.load(std::memory_order_relaxed)));
+    }
+
+    void setStoredExpiry(std::chrono::system_clock::time_point expiry)
+    { storedExpiry_.store(expiry.time_since_epoch().count(), std::memory_order_relaxed); }
+
     void setManager(SessionManager* sessionManager) 
-    { sessionManager_ = sessionManager; }
+    { sessionManager_.store(sessionManager, std::memory_order_relaxed); }
 
     SessionManager* getManager() const 
-    { return sessionManager_; }
+    { return sessionManager_.load(std::memory_order_relaxed); }
 
-    // 数据存取
+    // 数据存取：修改只记录脏字段，请求结束时由 SessionManager::commit 统一保存一次
     void setValue(const std::string&key, const std::string&value);
     std::string getValue(const std::string&key) const;
     void remove(const std::string&key);
     void clear();
+
+    // 所有字段的快照
+    std::unordered_map<std::string, std::string> values() const;
+
+    // 字段的紧凑编码，依次为 "<长度>:<名字><长度>:<值>"，供 Cookie、文件等持久化存储使用
+    void encodeValues(std::string* out) const;
+
+    // 解码 encodeValues 的结果并加到会话中（不算修改），格式错误时返回 false
+    bool decodeValues(std::string_view data);
+
+    bool isDirty() const;
+
+    // 取出并清空上次保存之后修改过（包括删除）的字段。保存前先取出：
+    // 保存期间其他请求的修改会重新标记为脏，由它们自己的 commit 保存，不会丢失
+    std::unordered_set<std::string> takeDirtyKeys();
+
+    // 本次请求新建、还没有保存过的会话（保存时下发 Cookie）
+    bool isNew() const
+    { return isNew_.load(std::memory_order_relaxed); }
+
+    void setNew(bool on)
+    { isNew_.store(on, std::memory_order_relaxed); }
+
+    // 已销毁的会话在请求结束时不再保存
+    void invalidate()
+    { invalidated_.store(true, std::memory_order_relaxed); }
+
+    bool isInvalidated() const
+    { return invalidated_.load(std::memory_order_relaxed); }
 private:
     std::string                                  sessionId_;
+    mutable std::mutex                           mutex_; // 保护 data_ 和 dirtyKeys_
     std::unordered_map<std::string, std::string> data_;
-    std::chrono::system_clock::time_point        expiryTime_;
+    std::unordered_set<std::string>              dirtyKeys_;
+    std::atomic<bool>                            isNew_ { false };
+    std::atomic<bool>                            invalidated_ { false };
+    // 过期时间（system_clock 的 tick 数）：请求线程刷新，会话存储的清理定时器读取
+    std::atomic<std::chrono::system_clock::rep>  expiryTime_;
+    std::atomic<std::chrono::system_clock::rep>  storedExpiry_ { 0 };
     int                                          maxAge_; // 过期时间（秒）
-    SessionManager*                              sessionManager_;
+    std::atomic<SessionManager*>                 sessionManager_;
 };
 
 } // namespace session
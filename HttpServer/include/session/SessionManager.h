@@ -5,6 +5,7 @@
 #include "../http/HttpResponse.h"
 #include <memory>
 #include <random>
+#include <string_view>
 
 namespace http
 {
@@ -14,30 +15,51 @@ namespace session
 class SessionManager
 {
 public:
+    // 保存会话 id（或 Cookie 会话数据）的 Cookie 名
+    static constexpr std::string_view kCookieName = "sessionId";
+
     explicit SessionManager(std::unique_ptr<SessionStorage> storage);
 
-    // 从请求中获取或创建会话
+    // 从请求中获取或创建会话。同一个请求中多次调用返回同一个会话，只访问一次存储；
+    // 修改在请求结束时由 commit 保存，新会话的 Cookie 也在那时下发（resp 不再使用，保留参数以兼容已有调用）
     std::shared_ptr<Session> getSession(const HttpRequest& req, HttpResponse* resp);
+
+    // 请求结束时由 HttpServer 调用：会话有修改时保存一次，没有修改时只延长过期时间，
+    // 没有修改过的新会话不保存
+    void commit(const HttpRequest& req, HttpResponse* resp);
     
      // 销毁会话
     void destroySession(const std::string& sessionId);
 
-    // 清理过期会话
+    // 销毁会话，并让浏览器删除会话 Cookie；本次请求结束时不再保存
+    void destroySession(Session& session);
+
+    // 清理过期会话（HttpServer 每秒调用一次）
     void cleanExpiredSessions();
 
-    // 更新会话
+    SessionStorage* storage() const
+    { return storage_.get(); }
+
+    // 会话 Cookie 加上 Secure 属性，只在 HTTPS 连接上发送。
+    // HttpServer 开启 TLS 时自动设置；TLS 由前置代理终止时需要手动设置
+    void setSecureCookie(bool secure)
+    { secureCookie_ = secure; }
+
+    // 立即保存会话（不等请求结束）
     void updateSession(std::shared_ptr<Session> session)
     {
+        session->takeDirtyKeys();
         storage_->save(session);
     }
 private:
     std::string generateSessionId();
     std::string getSessionIdFromCookie(const HttpRequest& req);
     void setSessionCookie(const std::string& sessionId, HttpResponse* resp);
+    void expireSessionCookie(HttpResponse* resp);
 
 private:
     std::unique_ptr<SessionStorage> storage_;
-    std::mt19937 rng_; // 用于生成随机会话id
+    bool                            secureCookie_ = false;
 };
 
 } // namespace session
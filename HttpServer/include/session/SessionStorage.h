@@ -1,6 +1,8 @@
 #pragma once
 #include "Session.h"
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace http
 {
@@ -14,16 +16,31 @@ public:
     virtual void save(std::shared_ptr<Session> session) = 0;
     virtual std::shared_ptr<Session> load(const std::string& sessionId) = 0;
     virtual void remove(const std::string& sessionId) = 0;
+
+    // 会话没有修改，只延长过期时间（请求结束时调用，代替 save），返回是否需要重新下发 Cookie。
+    // 内存存储中保存的就是会话对象本身，Session::refresh 已经生效，默认什么也不做
+    virtual bool touch(const std::shared_ptr<Session>&) { return false; }
+
+    // 会话 Cookie 的值。默认是会话 id；会话数据保存在 Cookie 中的存储（storesInCookie）返回编码后的会话，
+    // 每次 save 之后都要重新下发
+    virtual std::string cookieValue(const Session& session) { return session.getId(); }
+    virtual bool storesInCookie() const { return false; }
+
+    // 清理过期会话，由 SessionManager::cleanExpiredSessions 定时调用
+    virtual void removeExpired() {}
 };
 
-// 基于内存的会话存储实现
+// 基于内存的会话存储实现。一把锁保护整张表：IO 线程读写会话的同时，主线程的定时器会调用 removeExpired；
+// 多个 IO 线程并发访问较多时使用 ShardedSessionStorage
 class MemorySessionStorage : public SessionStorage
 {
 public:
     void save(std::shared_ptr<Session> session) override;
     std::shared_ptr<Session> load(const std::string& sessionId) override;
     void remove(const std::string& sessionId) override;
+    void removeExpired() override;
 private:
+    std::mutex                                                mutex_;
     std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
 };
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SessionStorage.h"
+#include "../utils/TimingWheel.h"
+
+namespace http
+{
+namespace session
+{
+
+// 线程安全的内存会话存储：按会话 id 的哈希分成 N 个分片，每个分片一把锁、一张哈希表和一个分层时间轮。
+// 会话第一次保存时按过期时间挂到时间轮上；访问会话只刷新会话自己的过期时间，不移动定时器，
+// 定时器到期时再检查：已过期则淘汰，否则按新的过期时间重新挂上（惰性重排）。
+// removeExpired 每次把各分片的时间轮推进到当前秒，由 HttpServer 的定时器每秒调用一次
+class ShardedSessionStorage : public SessionStorage
+{
+public:
+    struct Stats
+    {
+        size_t   sessions = 0;     // 当前会话数
+        uint64_t evictions = 0;    // 因过期被淘汰的会话数（定时器淘汰和加载时发现过期）
+        uint64_t acquisitions = 0; // 分片加锁次数
+        uint64_t contended = 0;    // 其中需要等待其他线程释放锁的次数
+    };
+
+    // 分片数向上取整为 2 的幂
+    explicit ShardedSessionStorage(size_t shardCount = 16);
+
+    void save(std::shared_ptr<Session> session) override;
+    std::shared_ptr<Session> load(const std::string& sessionId) override;
+    void remove(const std::string& sessionId) override;
+    void removeExpired() override;
+
+    Stats stats() const;
+    size_t shardCount() const { return shards_.size(); }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Session> session;
+        int64_t                  timerTick; // 当前有效的定时器刻度，时间轮中刻度不同的项已失效
+    };
+
+    // 每个分片独占缓存行，避免不同分片的锁和计数器伪共享
+    struct alignas(64) Shard
+    {
+        std::mutex                             mutex;
+        std::unordered_map<std::string, Entry> sessions;
+        TimingWheel<std::string>               wheel;
+        std::atomic<uint64_t>                  acquisitions { 0 };
+        std::atomic<uint64_t>                  contended { 0 };
+        std::atomic<uint64_t>                  evictions { 0 };
+
+        explicit Shard(int64_t now) : wheel(now) {}
+    };
+
+    Shard& shardFor(const std::string& sessionId);
+    static std::unique_lock<std::mutex> lock(Shard& shard);
+    static int64_t expiryTick(const Session& session);
+    static int64_t nowTick();
+
+private:
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t                              shardMask_;
+};
+
+} // namespace session
+} // namespace http
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace http
+{
+
+// gzip（zlib）/ brotli 压缩
+class CompressUtil
+{
+public:
+    // level: 1 ~ 9
+    static bool gzip(std::string_view input, int level, std::string* output);
+
+    // quality: 0 ~ 11
+    static bool brotli(std::string_view input, int quality, std::string* output);
+
+    // 值得压缩的内容类型（文本、JSON、JavaScript、SVG 等；图片和已压缩的格式不压缩）
+    static bool compressible(std::string_view contentType);
+};
+
+} // namespace http
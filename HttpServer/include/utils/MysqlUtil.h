@@ -1,8 +1,11 @@
  #pragma once
  #include "db/DbConnectionPool.h"
+ #include "db/QueryResult.h"
  
 #include <string>
 
+#include "../async/Awaitables.h"
+
 namespace http
 {
 
@@ -17,11 +20,19 @@ public:
             host, user, password, database, poolSize);
     }
 
+    // 连接池中预处理语句缓存的命中统计
+    static db::StatementCache::Stats statementStats()
+    {
+        return http::db::DbConnectionPool::getInstance().statementStats();
+    }
+
+    // 返回的结果持有连接租约，析构时才把连接还回连接池，读取结果时不要长时间持有
     template<typename... Args>
-    sql::ResultSet* executeQuery(const std::string& sql, Args&&... args)
+    db::QueryResult executeQuery(const std::string& sql, Args&&... args)
     {
         auto conn = http::db::DbConnectionPool::getInstance().getConnection();
-        return conn->executeQuery(sql, std::forward<Args>(args)...);
+        std::unique_ptr<sql::ResultSet> rs = conn->executeQuery(sql, std::forward<Args>(args)...);
+        return db::QueryResult(std::move(conn), std::move(rs));
     }
 
     template<typename... Args>
@@ -30,6 +41,24 @@ public:
         auto conn = http::db::DbConnectionPool::getInstance().getConnection();
         return conn->executeUpdate(sql, std::forward<Args>(args)...);
     }
+
+    // 供协程式处理器 co_await：在工作线程池中获取连接并执行，完成后回到当前 IO 线程。
+    // 参数按值保存，调用方的临时对象不必活到查询结束
+    template<typename... Args>
+    auto executeQueryAsync(WorkerPool* pool, const std::string& sql, Args... args)
+    {
+        return async::runInPool(pool, [this, sql, args...]() {
+            return executeQuery(sql, args...);
+        });
+    }
+
+    template<typename... Args>
+    auto executeUpdateAsync(WorkerPool* pool, const std::string& sql, Args... args)
+    {
+        return async::runInPool(pool, [this, sql, args...]() {
+            return executeUpdate(sql, args...);
+        });
+    }
 };
 
 } // namespace http
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace http
+{
+
+// 分层时间轮：4 层、每层 64 个槽，第 0 层一个槽一个刻度，第 k 层一个槽 64^k 个刻度，
+// 以秒为刻度时可以表示约 194 天内的到期时间，更远的到期时间先挂在最高层，转到时再重新放置。
+// 插入 O(1)；advance 每走一个刻度处理第 0 层的一个槽，低层转满一圈时把上一层对应槽中的项下放。
+// 不加锁，由调用方保护
+template <typename T>
+class TimingWheel
+{
+public:
+    explicit TimingWheel(int64_t now = 0)
+        : current_(now)
+    {}
+
+    int64_t current() const { return current_; }
+
+    // 在刻度 deadline 到期；已经过去的刻度在下一次 advance 时到期
+    void schedule(int64_t deadline, T value)
+    {
+        place(Item{ deadline, std::move(value) }, current_ + 1);
+    }
+
+    // 推进到刻度 now，对每个到期的项调用 onExpire(value, deadline)
+    template <typename OnExpire>
+    void advance(int64_t now, OnExpire&& onExpire)
+    {
+        while (current_ < now)
+        {
+            ++current_;
+            cascade(1);
+
+            std::vector<Item> due;
+            due.swap(slots_[0][current_ & kSlotMask]);
+            for (Item& item : due)
+            {
+                if (item.deadline <= current_)
+                {
+                    onExpire(item.value, item.deadline);
+                }
+                else
+                {
+                    // 还没到期（防御性处理），重新放置
+                    place(std::move(item), current_ + 1);
+                }
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        size_t count = 0;
+        for (const auto& level : slots_)
+        {
+            for (const auto& slot : level)
+            {
+                count += slot.size();
+            }
+        }
+        return count;
+    }
+
+private:
+    static constexpr int     kLevels = 4;
+    static constexpr int     kBits = 6;
+    static constexpr int64_t kSlots = int64_t(1) << kBits;
+    static constexpr int64_t kSlotMask = kSlots - 1;
+
+    struct Item
+    {
+        int64_t deadline;
+        T       value;
+    };
+
+    // 放到能容纳 deadline 的最低一层；earliest 之前到期的项放在 earliest
+    void place(Item item, int64_t earliest)
+    {
+        int64_t tick = item.deadline < earliest ? earliest : item.deadline;
+        int64_t delta = tick - current_;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (int64_t(1) << (kBits * (level + 1))))
+        {
+            ++level;
+        }
+        int64_t maxDelta = (int64_t(1) << (kBits * kLevels)) - 1;
+        if (delta > maxDelta)
+        {
+            tick = current_ + maxDelta;
+        }
+        slots_[level][(tick >> (kBits * level)) & kSlotMask].push_back(std::move(item));
+    }
+
+    // 第 level - 1 层转满一圈时，把第 level 层当前槽中的项下放到更低的层
+    void cascade(int level)
+    {
+        if (level >= kLevels || (current_ & ((int64_t(1) << (kBits * level)) - 1)) != 0)
+        {
+            return;
+        }
+        cascade(level + 1);
+        std::vector<Item> items;
+        items.swap(slots_[level][(current_ >> (kBits * level)) & kSlotMask]);
+        for (Item& item : items)
+        {
+            // 下放时当前刻度的槽还没有处理，正好在本刻度到期的项放在当前刻度
+            place(std::move(item), current_);
+        }
+    }
+
+private:
+    int64_t                                             current_; // 已经处理到的刻度
+    std::array<std::array<std::vector<Item>, kSlots>, kLevels> slots_;
+};
+
+} // namespace http
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <muduo/base/noncopyable.h>
+
+namespace http
+{
+
+// 有界的工作窃取线程池，执行会阻塞的任务（数据库访问、AI 计算等），不占用 IO 线程。
+// 每个工作线程有自己的任务队列，提交时轮流放入各个队列；线程自己的队列空了就从其他队列的头部窃取，任务大致按提交顺序执行。
+// 排队的任务总数达到上限或 stop() 之后 post 返回 false，由调用方决定如何拒绝，慢任务堆积时不会无限占用内存
+class WorkerPool : muduo::noncopyable
+{
+public:
+    using Task = std::function<void ()>;
+
+    WorkerPool(size_t threadNum, size_t maxQueued);
+    ~WorkerPool();
+
+    void start();
+    // 执行完已提交的任务后退出所有工作线程，之后的 post 都被拒绝
+    void stop();
+
+    // 排队已满或线程池已停止时返回 false，任务不会执行
+    bool post(Task task);
+
+    size_t queued() const
+    { return queued_.load(std::memory_order_relaxed); }
+
+    size_t threadNum() const
+    { return queues_.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+    // 先取自己队列的头部，再从其他队列的头部窃取
+    bool take(size_t index, Task* task);
+
+private:
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread>            threads_;
+    const size_t                        maxQueued_;
+    std::atomic<size_t>                 queued_ { 0 }; // 已提交还没开始执行的任务数
+    std::atomic<size_t>                 next_ { 0 }; // 下一个任务放入的队列
+    std::mutex                          mutex_; // 配合 cond_ 让空闲线程休眠
+    std::condition_variable             cond_;
+    bool                                running_ { false };
+    bool                                stopped_ { false }; // stop() 之后拒绝新任务
+};
+
+} // namespace http
@@ -9,6 +9,8 @@
 #include <mysql/mysql.h>
 #include <muduo/base/Logging.h>
 #include "DbException.h"
+#include "ParamBinder.h"
+#include "StatementCache.h"
 
 namespace http 
 {
@@ -21,87 +23,90 @@ public:
     DbConnection(const std::string& host, 
                 const std::string& user,
                 const std::string& password,
-                const std::string& database);
+                const std::string& database,
+                size_t statementCacheSize = StatementCache::kDefaultCapacity);
     ~DbConnection();
 
     // 禁止拷贝
     DbConnection(const DbConnection&) = delete;
     DbConnection& operator=(const DbConnection&) = delete;
 
+    // 以下三个方法都持有连接的互斥锁，和本连接上的查询互斥
     bool isValid();
     void reconnect();
     void cleanup();
 
+    // 语句从本连接的缓存中取出（同一 SQL 只在第一次执行时 prepare），参数按类型绑定，见 ParamBinder。
+    // 结果集依赖缓存中的语句：读完之前不要在本连接上再执行同一条 SQL。
+    // 从连接池借出连接时使用 MysqlUtil::executeQuery，返回的 QueryResult 会一直持有连接直到读完
     template<typename... Args>
-    sql::ResultSet* executeQuery(const std::string& sql, Args&&... args)
+    std::unique_ptr<sql::ResultSet> executeQuery(const std::string& sql, Args&&... args)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        try 
-        {
-            // 直接创建新的预处理语句，不使用缓存
-            std::unique_ptr<sql::PreparedStatement> stmt(
-                conn_->prepareStatement(sql)
-            );
-            bindParams(stmt.get(), 1, std::forward<Args>(args)...);
-            return stmt->executeQuery();
-        } 
-        catch (const sql::SQLException& e) 
-        {
-            LOG_ERROR << "Query failed: " << e.what() << ", SQL: " << sql;
-            throw DbException(e.what());
-        }
+        return execute(sql, "Query", true, [&](sql::PreparedStatement* stmt) {
+            ParamBinder binder(stmt);
+            binder.bind(args...);
+            return std::unique_ptr<sql::ResultSet>(stmt->executeQuery());
+        });
     }
     
     template<typename... Args>
     int executeUpdate(const std::string& sql, Args&&... args)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        try 
-        {
-            // 直接创建新的预处理语句，不使用缓存
-            std::unique_ptr<sql::PreparedStatement> stmt(
-                conn_->prepareStatement(sql)
-            );
-            bindParams(stmt.get(), 1, std::forward<Args>(args)...);
+        return execute(sql, "Update", false, [&](sql::PreparedStatement* stmt) {
+            ParamBinder binder(stmt);
+            binder.bind(args...);
             return stmt->executeUpdate();
-        } 
-        catch (const sql::SQLException& e) 
-        {
-            LOG_ERROR << "Update failed: " << e.what() << ", SQL: " << sql;
-            throw DbException(e.what());
-        }
+        });
     }
 
+    // 预处理语句缓存的命中统计
+    StatementCache::Stats statementStats() const { return statements_.stats(); }
+
     bool ping();  // 添加检测连接是否有效的方法
 private:
-     // 辅助函数：递归终止条件
-    void bindParams(sql::PreparedStatement*, int) {}
-    
-    // 辅助函数：绑定参数
-    template<typename T, typename... Args>
-    void bindParams(sql::PreparedStatement* stmt, int index, 
-                   T&& value, Args&&... args) 
+    // 连接开启了 OPT_RECONNECT，驱动在连接断开后会悄悄重连，服务器端的预处理语句随旧会话一起失效，
+    // 缓存中的语句句柄再执行时报错。遇到这类错误时清空缓存、重新 prepare 后重试一次。
+    // 更新语句在 CR_SERVER_LOST（执行中断开，可能已经执行）时不重试，避免重复执行
+    template<typename Fn>
+    auto execute(const std::string& sql, const char* kind, bool idempotent, Fn&& fn)
     {
-        stmt->setString(index, std::to_string(std::forward<T>(value)));
-        bindParams(stmt, index + 1, std::forward<Args>(args)...);
-    }
-    
-    // 特化 string 类型的参数绑定
-    template<typename... Args>
-    void bindParams(sql::PreparedStatement* stmt, int index, 
-                   const std::string& value, Args&&... args) 
-    {
-        stmt->setString(index, value);
-        bindParams(stmt, index + 1, std::forward<Args>(args)...);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int attempt = 0; ; ++attempt)
+        {
+            try 
+            {
+                return fn(statements_.acquire(conn_.get(), sql));
+            } 
+            catch (const sql::SQLException& e) 
+            {
+                if (attempt == 0 && isStaleStatementError(e.getErrorCode(), idempotent))
+                {
+                    LOG_WARN << kind << " hit a lost connection (" << e.getErrorCode()
+                             << "), re-preparing statements and retrying, SQL: " << sql;
+                    statements_.clear();
+                    continue;
+                }
+                // 语句可能已经不可用，丢弃后下次重新准备
+                statements_.evict(sql);
+                LOG_ERROR << kind << " failed: " << e.what() << ", SQL: " << sql;
+                throw DbException(e.what());
+            }
+        }
     }
 
-private:
+    static bool isStaleStatementError(int errorCode, bool idempotent);
+
+    // 调用方持有 mutex_
+    void reconnectLocked();
+
     std::shared_ptr<sql::Connection> conn_;
     std::string                      host_;
     std::string                      user_;
     std::string                      password_;
     std::string                      database_;
     std::mutex                       mutex_;
+    // 声明在 conn_ 之后：先于连接析构，语句在连接关闭前释放
+    StatementCache                   statements_;
 };
 
 } // namespace db
@@ -4,6 +4,7 @@
 #include <condition_variable>
 #include <memory>
 #include <thread>
+#include <vector>
 #include "DbConnection.h"
 
 namespace http 
@@ -31,6 +32,9 @@ public:
     // 获取连接
     std::shared_ptr<DbConnection> getConnection();
 
+    // 所有连接的预处理语句缓存统计之和
+    StatementCache::Stats statementStats();
+
 private:
     // 构造函数
     DbConnectionPool();
@@ -51,6 +55,7 @@ private:
     std::string                               password_;
     std::string                               database_;
     std::queue<std::shared_ptr<DbConnection>> connections_;
+    std::vector<std::shared_ptr<DbConnection>> allConnections_; // 含已借出的连接，用于汇总统计
     std::mutex                                mutex_;
     std::condition_variable                   cv_;
     bool                                      initialized_ = false;
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <cppconn/datatype.h>
+#include <cppconn/prepared_statement.h>
+
+namespace http
+{
+namespace db
+{
+
+// 以二进制方式绑定的参数（BLOB/VARBINARY 列），只引用调用方的数据，执行完成前必须保持有效
+struct Blob
+{
+    std::string_view data;
+};
+
+// 按参数的静态类型选择 PreparedStatement 的 setXxx，编译期完成分派：
+// bool -> setBoolean，32 位及以下整数 -> setInt/setUInt，64 位整数 -> setInt64/setUInt64，
+// 浮点 -> setDouble，字符串 -> setString，Blob -> setBlob，
+// nullptr / std::nullopt / 空的 std::optional -> setNull，枚举按底层整数绑定。
+// 不支持的类型在编译期报错，而不是像 std::to_string 那样悄悄转成字符串
+class ParamBinder
+{
+public:
+    explicit ParamBinder(sql::PreparedStatement* stmt)
+        : stmt_(stmt)
+    {}
+
+    ParamBinder(const ParamBinder&) = delete;
+    ParamBinder& operator=(const ParamBinder&) = delete;
+
+    // 从第 1 个占位符开始依次绑定
+    template<typename... Args>
+    void bind(const Args&... args)
+    {
+        unsigned int index = 1;
+        (bindOne(index++, args), ...);
+    }
+
+    template<typename T>
+    void bindOne(unsigned int index, const T& value)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>)
+        {
+            stmt_->setBoolean(index, value);
+        }
+        else if constexpr (std::is_enum_v<U>)
+        {
+            bindOne(index, static_cast<std::underlying_type_t<U>>(value));
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U> && sizeof(U) <= sizeof(int32_t))
+        {
+            stmt_->setInt(index, static_cast<int32_t>(value));
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_unsigned_v<U> && sizeof(U) <= sizeof(uint32_t))
+        {
+            stmt_->setUInt(index, static_cast<uint32_t>(value));
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        {
+            stmt_->setInt64(index, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            stmt_->setUInt64(index, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            stmt_->setDouble(index, static_cast<double>(value));
+        }
+        else if constexpr (std::is_same_v<U, std::nullptr_t> || std::is_same_v<U, std::nullopt_t>)
+        {
+            stmt_->setNull(index, sql::DataType::SQLNULL);
+        }
+        else if constexpr (std::is_same_v<U, Blob>)
+        {
+            bindBlob(index, value.data);
+        }
+        else if constexpr (std::is_same_v<U, std::string>)
+        {
+            stmt_->setString(index, value);
+        }
+        else if constexpr (std::is_convertible_v<const U&, std::string_view>)
+        {
+            stmt_->setString(index, std::string(std::string_view(value)));
+        }
+        else if constexpr (IsOptional<U>::value)
+        {
+            if (value)
+            {
+                bindOne(index, *value);
+            }
+            else
+            {
+                stmt_->setNull(index, sql::DataType::SQLNULL);
+            }
+        }
+        else
+        {
+            static_assert(sizeof(U) == 0, "unsupported SQL parameter type");
+        }
+    }
+
+private:
+    template<typename T>
+    struct IsOptional : std::false_type {};
+    template<typename T>
+    struct IsOptional<std::optional<T>> : std::true_type {};
+
+    // 直接读取调用方内存的只读流，避免 istringstream 复制一份数据
+    class BlobStream : private std::streambuf, public std::istream
+    {
+    public:
+        explicit BlobStream(std::string_view data)
+            : std::istream(static_cast<std::streambuf*>(this))
+        {
+            char* begin = const_cast<char*>(data.data());
+            setg(begin, begin, begin + data.size());
+        }
+    };
+
+    void bindBlob(unsigned int index, std::string_view data)
+    {
+        // 驱动只保存流指针，执行时才读取，所以流要活到 binder 析构
+        blobs_.push_back(std::make_unique<BlobStream>(data));
+        stmt_->setBlob(index, blobs_.back().get());
+    }
+
+    sql::PreparedStatement*                  stmt_;
+    std::vector<std::unique_ptr<BlobStream>> blobs_;
+};
+
+} // namespace db
+} // namespace http
@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <cppconn/resultset.h>
+
+namespace http
+{
+namespace db
+{
+
+class DbConnection;
+
+// 结果集当前行的只读视图，按目标类型选择 getXxx，编译期完成分派。
+// 列号从 1 开始；按列名访问时先用 findColumn 换成列号。
+// 支持 bool、各宽度整数、枚举、浮点、std::string，以及 std::optional<T>（NULL 时为空）
+class Row
+{
+public:
+    explicit Row(sql::ResultSet* rs)
+        : rs_(rs)
+    {}
+
+    template<typename T>
+    T get(uint32_t column) const
+    {
+        if constexpr (IsOptional<T>::value)
+        {
+            if (rs_->isNull(column))
+            {
+                return std::nullopt;
+            }
+            return get<typename T::value_type>(column);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            return rs_->getBoolean(column);
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            return static_cast<T>(get<std::underlying_type_t<T>>(column));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= sizeof(int32_t))
+        {
+            return static_cast<T>(rs_->getInt(column));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) <= sizeof(uint32_t))
+        {
+            return static_cast<T>(rs_->getUInt(column));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            return static_cast<T>(rs_->getInt64(column));
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return static_cast<T>(rs_->getUInt64(column));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return static_cast<T>(rs_->getDouble(column));
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            return rs_->getString(column);
+        }
+        else
+        {
+            static_assert(sizeof(T) == 0, "unsupported SQL column type");
+        }
+    }
+
+    template<typename T>
+    T get(const std::string& label) const
+    {
+        return get<T>(rs_->findColumn(label));
+    }
+
+    bool isNull(uint32_t column) const { return rs_->isNull(column); }
+    bool isNull(const std::string& label) const { return rs_->isNull(rs_->findColumn(label)); }
+
+    // 按列顺序（从第 1 列开始）直接写入 out 的成员，不经过中间的行对象
+    template<typename T, typename... Members>
+    void into(T& out, Members T::*... members) const
+    {
+        uint32_t column = 1;
+        ((out.*members = get<Members>(column++)), ...);
+    }
+
+private:
+    template<typename T>
+    struct IsOptional : std::false_type {};
+    template<typename T>
+    struct IsOptional<std::optional<T>> : std::true_type {};
+
+    sql::ResultSet* rs_;
+};
+
+// 查询结果：持有结果集，以及执行查询的连接租约（从连接池借出的 shared_ptr）。
+// 析构时先释放结果集，再把连接还回连接池，因此读取期间连接和其中缓存的预处理语句
+// 不会被其他线程拿去执行新的查询。只能移动，不能拷贝。
+// 逐行读取，不把整个结果复制成中间容器：
+//
+//   db::QueryResult result = mysqlUtil.executeQuery("SELECT id, name FROM users");
+//   for (const db::Row& row : result) { row.get<int>(1); row.get<std::string>("name"); }
+//
+//   User user;
+//   while (result.next(user, &User::id, &User::name)) { ... }
+class QueryResult
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Row*;
+        using reference = const Row&;
+
+        explicit Iterator(QueryResult* result = nullptr)
+            : result_(result)
+        {}
+
+        reference operator*() const { return result_->row(); }
+        pointer operator->() const { return &result_->row(); }
+
+        Iterator& operator++()
+        {
+            if (!result_->next())
+            {
+                result_ = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& other) const { return result_ == other.result_; }
+        bool operator!=(const Iterator& other) const { return result_ != other.result_; }
+
+    private:
+        QueryResult* result_;
+    };
+
+    QueryResult() = default;
+    QueryResult(std::shared_ptr<DbConnection> lease, std::unique_ptr<sql::ResultSet> rs);
+    ~QueryResult();
+
+    QueryResult(QueryResult&& other) noexcept;
+    QueryResult& operator=(QueryResult&& other) noexcept;
+    QueryResult(const QueryResult&) = delete;
+    QueryResult& operator=(const QueryResult&) = delete;
+
+    // 前进到下一行，没有更多行时返回 false
+    bool next();
+
+    // 前进到下一行并按列顺序写入 out 的成员
+    template<typename T, typename... Members>
+    bool next(T& out, Members T::*... members)
+    {
+        if (!next())
+        {
+            return false;
+        }
+        row_.into(out, members...);
+        return true;
+    }
+
+    // 当前行，只在 next() 返回 true 之后有效
+    const Row& row() const { return row_; }
+
+    template<typename T, typename Column>
+    T get(const Column& column) const
+    {
+        return row_.get<T>(column);
+    }
+
+    // 结果集只能从头读到尾一次：begin() 读取第一行，迭代过程中调用 next() 会跳过行
+    Iterator begin() { return next() ? Iterator(this) : Iterator(); }
+    Iterator end() { return Iterator(); }
+
+    // 提前释放结果集并归还连接
+    void reset();
+
+private:
+    // 成员声明顺序决定析构顺序：rs_ 先于 lease_ 释放
+    std::shared_ptr<DbConnection>  lease_;
+    std::unique_ptr<sql::ResultSet> rs_;
+    Row                            row_{ nullptr };
+};
+
+} // namespace db
+} // namespace http
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cppconn/connection.h>
+#include <cppconn/prepared_statement.h>
+
+namespace http
+{
+namespace db
+{
+
+// 单个连接上的预处理语句缓存：以 SQL 文本为键，按 LRU 淘汰。
+// 命中时直接复用服务器端已准备好的语句，省去每次 prepareStatement 的一次往返；
+// 容量有上限，拼接出来的一次性 SQL 不会无限占用服务器的 max_prepared_stmt_count。
+// 不加锁，由所属的 DbConnection 在自己的互斥锁内调用；统计计数为原子变量，可在锁外读取
+class StatementCache
+{
+public:
+    static constexpr size_t kDefaultCapacity = 64;
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t   size = 0;
+
+        double hitRate() const
+        {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+        }
+
+        Stats& operator+=(const Stats& other)
+        {
+            hits += other.hits;
+            misses += other.misses;
+            evictions += other.evictions;
+            size += other.size;
+            return *this;
+        }
+    };
+
+    explicit StatementCache(size_t capacity = kDefaultCapacity);
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // 取出 sql 对应的语句，未命中时在 conn 上准备并放入缓存（可能淘汰最久未用的语句）。
+    // 返回的指针在下一次 acquire/evict/clear 之前有效
+    sql::PreparedStatement* acquire(sql::Connection* conn, const std::string& sql);
+
+    // 语句执行出错时丢弃，下次重新准备
+    void evict(const std::string& sql);
+    // 重连前调用：旧连接上的语句全部失效
+    void clear();
+
+    Stats  stats() const;
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Entry
+    {
+        std::string                             sql;
+        std::unique_ptr<sql::PreparedStatement> stmt;
+    };
+    using EntryList = std::list<Entry>;
+
+    size_t                                                    capacity_;
+    EntryList                                                 lru_;   // 表头为最近使用
+    std::unordered_map<std::string_view, EntryList::iterator> index_; // 键指向链表节点中的 sql，节点地址不变
+    std::atomic<uint64_t>                                     hits_{0};
+    std::atomic<uint64_t>                                     misses_{0};
+    std::atomic<uint64_t>                                     evictions_{0};
+    std::atomic<size_t>                                       size_{0};
+};
+
+} // namespace db
+} // namespace http
@@ -0,0 +1,78 @@
+#include "../../include/http/Cookies.h"
+
+namespace http
+{
+
+namespace
+{
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// 从 header 头部取出下一个 Cookie，跳过格式不对的项；没有更多 Cookie 时返回 false
+bool nextCookie(std::string_view& header, RequestCookies::Cookie* cookie)
+{
+    while (!header.empty())
+    {
+        size_t end = header.find(';');
+        std::string_view pair = header.substr(0, end);
+        header = end == std::string_view::npos ? std::string_view() : header.substr(end + 1);
+
+        size_t eq = pair.find('=');
+        if (eq == std::string_view::npos)
+        {
+            continue;
+        }
+        std::string_view name = trim(pair.substr(0, eq));
+        std::string_view value = trim(pair.substr(eq + 1));
+        if (name.empty())
+        {
+            continue;
+        }
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        {
+            value = value.substr(1, value.size() - 2);
+        }
+        *cookie = RequestCookies::Cookie{ name, value };
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void RequestCookies::parse(std::string_view header)
+{
+    size_ = 0;
+    while (size_ < kCapacity && nextCookie(header, &cookies_[size_]))
+    {
+        ++size_;
+    }
+    rest_ = header;
+}
+
+std::string_view RequestCookies::findInRest(std::string_view name) const
+{
+    std::string_view header = rest_;
+    Cookie cookie;
+    while (nextCookie(header, &cookie))
+    {
+        if (cookie.name == name)
+        {
+            return cookie.value;
+        }
+    }
+    return std::string_view();
+}
+
+} // namespace http
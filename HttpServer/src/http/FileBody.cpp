@@ -0,0 +1,71 @@
+#include "../../include/http/FileBody.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+
+std::shared_ptr<const FileBody> FileBody::open(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    char etag[80];
+    snprintf(etag, sizeof etag, "\"%llx-%llx-%llx\"",
+             static_cast<unsigned long long>(st.st_ino),
+             static_cast<unsigned long long>(st.st_size),
+             static_cast<unsigned long long>(st.st_mtim.tv_sec) * 1000000000ULL +
+                 static_cast<unsigned long long>(st.st_mtim.tv_nsec));
+    return std::shared_ptr<const FileBody>(
+        new FileBody(fd, static_cast<size_t>(st.st_size), st.st_mtime, etag, path));
+}
+
+FileBody::~FileBody()
+{
+    ::close(fd_);
+}
+
+ssize_t FileBody::read(off_t offset, char* buf, size_t len) const
+{
+    return ::pread(fd_, buf, len, offset);
+}
+
+bool FileBody::readRange(size_t offset, size_t len, std::string* out) const
+{
+    out->resize(len);
+    size_t done = 0;
+    while (done < len)
+    {
+        ssize_t n = read(static_cast<off_t>(offset + done), &(*out)[done], len - done);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            LOG_ERROR << "read " << path_ << " failed, errno=" << errno;
+            out->resize(done);
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace http
@@ -0,0 +1,184 @@
+#include "../../include/http/HeaderScanner.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HTTP_HEADER_SCANNER_X86 1
+#endif
+
+namespace http
+{
+
+namespace
+{
+
+// 扫描状态：当前行的起始位置和第一个冒号
+struct ScanState
+{
+    const char*           lineBegin;
+    const char*           colon;
+    HeaderScanner::Line*  lines;
+    size_t                maxLines;
+    size_t                count;
+};
+
+// 处理一个分隔符，返回 true 表示需要停止扫描（遇到空行或输出已满）
+inline bool onDelimiter(ScanState& st, const char* p)
+{
+    if (*p == ':')
+    {
+        if (st.colon == nullptr)
+        {
+            st.colon = p;
+        }
+        return false;
+    }
+
+    // '\n'：一行结束，兼容只有 \n 没有 \r 的客户端
+    const char* lineEnd = (p > st.lineBegin && *(p - 1) == '\r') ? p - 1 : p;
+    HeaderScanner::Line& line = st.lines[st.count++];
+    line.begin = st.lineBegin;
+    line.colon = (st.colon != nullptr && st.colon < lineEnd) ? st.colon : lineEnd;
+    line.end = lineEnd;
+
+    st.lineBegin = p + 1;
+    st.colon = nullptr;
+    return line.begin == line.end || st.count == st.maxLines;
+}
+
+// 逐字节处理 [p, end)，返回 true 表示已停止
+inline bool scanTail(ScanState& st, const char* p, const char* end)
+{
+    for (; p < end; ++p)
+    {
+        if ((*p == ':' || *p == '\n') && onDelimiter(st, p))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 处理一个分块的分隔符位图，返回 true 表示已停止
+inline bool scanMask(ScanState& st, const char* chunk, uint32_t mask)
+{
+    while (mask != 0)
+    {
+        const char* p = chunk + __builtin_ctz(mask);
+        mask &= mask - 1;
+        if (onDelimiter(st, p))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t scanScalar(const char* begin, const char* end,
+                  HeaderScanner::Line* lines, size_t maxLines, const char** next)
+{
+    ScanState st{begin, nullptr, lines, maxLines, 0};
+    if (maxLines > 0)
+    {
+        scanTail(st, begin, end);
+    }
+    *next = st.lineBegin;
+    return st.count;
+}
+
+#ifdef HTTP_HEADER_SCANNER_X86
+
+__attribute__((target("sse4.2")))
+size_t scanSse42(const char* begin, const char* end,
+                 HeaderScanner::Line* lines, size_t maxLines, const char** next)
+{
+    ScanState st{begin, nullptr, lines, maxLines, 0};
+    if (maxLines == 0)
+    {
+        *next = begin;
+        return 0;
+    }
+
+    // PCMPESTRM 一条指令比较 16 字节与 {':', '\n'} 中的任意一个
+    const __m128i needle = _mm_setr_epi8(':', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const char* p = begin;
+    bool stopped = false;
+    for (; !stopped && end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_cmpestrm(needle, 2, chunk, 16,
+                                    _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+        stopped = scanMask(st, p, static_cast<uint32_t>(_mm_cvtsi128_si32(hits)) & 0xFFFF);
+    }
+    if (!stopped)
+    {
+        scanTail(st, p, end);
+    }
+    *next = st.lineBegin;
+    return st.count;
+}
+
+__attribute__((target("avx2")))
+size_t scanAvx2(const char* begin, const char* end,
+                HeaderScanner::Line* lines, size_t maxLines, const char** next)
+{
+    ScanState st{begin, nullptr, lines, maxLines, 0};
+    if (maxLines == 0)
+    {
+        *next = begin;
+        return 0;
+    }
+
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const char* p = begin;
+    bool stopped = false;
+    for (; !stopped && end - p >= 32; p += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon),
+                                       _mm256_cmpeq_epi8(chunk, newline));
+        stopped = scanMask(st, p, static_cast<uint32_t>(_mm256_movemask_epi8(hits)));
+    }
+    if (!stopped)
+    {
+        scanTail(st, p, end);
+    }
+    *next = st.lineBegin;
+    return st.count;
+}
+
+#endif // HTTP_HEADER_SCANNER_X86
+
+HeaderScanner::ScanFunc selectScanFunc(const char** name)
+{
+#ifdef HTTP_HEADER_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2";
+        return scanAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        *name = "sse4.2";
+        return scanSse42;
+    }
+#endif
+    *name = "scalar";
+    return scanScalar;
+}
+
+const char* g_implementation = "scalar";
+
+} // namespace
+
+HeaderScanner::ScanFunc HeaderScanner::scanFunc_ = selectScanFunc(&g_implementation);
+
+const char* HeaderScanner::implementation()
+{
+    return g_implementation;
+}
+
+} // namespace http
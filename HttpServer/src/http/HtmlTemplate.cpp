@@ -0,0 +1,188 @@
+#include "../../include/http/HtmlTemplate.h"
+
+#include <algorithm>
+
+#include "../../include/utils/CompressUtil.h"
+
+namespace http
+{
+
+namespace
+{
+
+const std::string_view kOpen = "{{";
+// 与 CompressionConfig 的默认现场压缩级别相同
+const int kGzipLevel = 6;
+const int kBrotliQuality = 5;
+const std::string_view kClose = "}}";
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// 一次渲染的结果：持有模板（静态片段引用它的源文本）和各占位符的值，
+// 作为分段响应体的 owner，响应发送完之前保持有效
+struct RenderedPage
+{
+    std::shared_ptr<const HtmlTemplate> tmpl;
+    std::vector<std::string>            values;
+};
+
+} // namespace
+
+std::shared_ptr<const HtmlTemplate> HtmlTemplate::compile(std::shared_ptr<const std::string> source)
+{
+    std::shared_ptr<HtmlTemplate> tmpl(new HtmlTemplate(std::move(source)));
+    std::string_view text(*tmpl->source_);
+
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        size_t open = text.find(kOpen, pos);
+        size_t close = open == std::string_view::npos ? std::string_view::npos
+                                                      : text.find(kClose, open + kOpen.size());
+        if (close == std::string_view::npos)
+        {
+            break;
+        }
+        std::string_view name = trim(text.substr(open + kOpen.size(), close - open - kOpen.size()));
+
+        if (open > pos)
+        {
+            tmpl->parts_.push_back(Part{ text.substr(pos, open - pos), -1 });
+        }
+        auto it = std::find(tmpl->slotNames_.begin(), tmpl->slotNames_.end(), name);
+        int slot = static_cast<int>(it - tmpl->slotNames_.begin());
+        if (it == tmpl->slotNames_.end())
+        {
+            tmpl->slotNames_.push_back(name);
+        }
+        tmpl->parts_.push_back(Part{ std::string_view(), slot });
+        pos = close + kClose.size();
+    }
+    if (pos < text.size())
+    {
+        tmpl->parts_.push_back(Part{ text.substr(pos), -1 });
+    }
+    return tmpl;
+}
+
+std::vector<std::string> HtmlTemplate::resolve(std::initializer_list<Value> values) const
+{
+    std::vector<std::string> resolved(slotNames_.size());
+    for (const auto& value : values)
+    {
+        auto it = std::find(slotNames_.begin(), slotNames_.end(), value.first);
+        if (it != slotNames_.end())
+        {
+            resolved[it - slotNames_.begin()] = value.second;
+        }
+    }
+    return resolved;
+}
+
+void HtmlTemplate::render(std::initializer_list<Value> values, HttpResponse* resp) const
+{
+    auto page = std::make_shared<RenderedPage>();
+    page->tmpl = shared_from_this();
+    page->values = resolve(values);
+
+    std::vector<std::string_view> segments;
+    segments.reserve(parts_.size());
+    for (const Part& part : parts_)
+    {
+        std::string_view segment = part.slot < 0 ? part.text : std::string_view(page->values[part.slot]);
+        if (!segment.empty())
+        {
+            segments.push_back(segment);
+        }
+    }
+    Compressed variants = compressed(page->values);
+    resp->setBody(std::move(page), std::move(segments));
+    resp->setPrecompressed(std::move(variants.gzip), std::move(variants.brotli));
+    // 缓存中是判断为不值得压缩的页面，不再现场压缩
+    resp->setLiveCompression(false);
+}
+
+HtmlTemplate::Compressed HtmlTemplate::compressed(const std::vector<std::string>& resolved) const
+{
+    std::string key;
+    for (const std::string& value : resolved)
+    {
+        key += value;
+        key += '\0';
+    }
+    {
+        std::lock_guard<std::mutex> lock(compressedMutex_);
+        auto it = compressed_.find(key);
+        if (it != compressed_.end())
+        {
+            return it->second;
+        }
+    }
+
+    // 压缩不持锁；两个线程同时压缩同一组取值时结果相同，后放入的覆盖先放入的
+    Compressed result;
+    std::string page = join(resolved);
+    if (page.size() >= kMinCompressSize)
+    {
+        auto gzip = std::make_shared<std::string>();
+        if (CompressUtil::gzip(page, kGzipLevel, gzip.get()) && gzip->size() < page.size())
+        {
+            result.gzip = std::move(gzip);
+        }
+        auto brotli = std::make_shared<std::string>();
+        if (CompressUtil::brotli(page, kBrotliQuality, brotli.get()) && brotli->size() < page.size())
+        {
+            result.brotli = std::move(brotli);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(compressedMutex_);
+    if (compressed_.size() >= kMaxCompressedRenders)
+    {
+        compressed_.clear();
+    }
+    compressed_[std::move(key)] = result;
+    return result;
+}
+
+std::string HtmlTemplate::renderToString(std::initializer_list<Value> values) const
+{
+    return join(resolve(values));
+}
+
+std::string HtmlTemplate::join(const std::vector<std::string>& resolved) const
+{
+    size_t size = 0;
+    for (const Part& part : parts_)
+    {
+        size += part.slot < 0 ? part.text.size() : resolved[part.slot].size();
+    }
+
+    std::string out;
+    out.reserve(size);
+    for (const Part& part : parts_)
+    {
+        if (part.slot < 0)
+        {
+            out.append(part.text);
+        }
+        else
+        {
+            out.append(resolved[part.slot]);
+        }
+    }
+    return out;
+}
+
+} // namespace http
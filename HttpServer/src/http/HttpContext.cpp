@@ -1,5 +1,8 @@
 #include "../../include/http/HttpContext.h"
 
+#include <algorithm>
+#include <charconv>
+
 using namespace muduo;
 using namespace muduo::net;
 
@@ -7,22 +10,36 @@ namespace http
 {
 
 // 将报文解析出来将关键信息封装到HttpRequest对象里面去
+// 解析过程中不回收缓冲区，HttpRequest 中的字段直接引用缓冲区中的数据，
+// 由 HttpServer 在响应发送之后按 requestBytes() 回收
 bool HttpContext::parseRequest(Buffer *buf, Timestamp receiveTime)
 {
+    // 上一次回调只收到半个请求，期间缓冲区可能搬移过数据，已解析的字段要跟着平移
+    // （请求头已经 detach 的请求不再引用缓冲区，base_ 为空）
+    if (base_ != nullptr && base_ != buf->peek())
+    {
+        request_.rebase(base_, buf->peek());
+    }
+    if (base_ != nullptr || state_ == kExpectRequestLine)
+    {
+        base_ = buf->peek();
+    }
+
     bool ok = true; // 解析每行请求格式是否正确
     bool hasMore = true;
     while (hasMore)
     {
+        const char *cursor = buf->peek() + parsedBytes_;
         if (state_ == kExpectRequestLine)
         {
-            const char *crlf = buf->findCRLF(); // 注意这个返回值边界可能有错
+            const char *crlf = buf->findCRLF(cursor);
             if (crlf)
             {
-                ok = processRequestLine(buf->peek(), crlf);
+                ok = processRequestLine(cursor, crlf);
                 if (ok)
                 {
                     request_.setReceiveTime(receiveTime);
-                    buf->retrieveUntil(crlf + 2);
+                    parsedBytes_ = crlf + 2 - buf->peek();
                     state_ = kExpectHeaders;
                 }
                 else
@@ -37,82 +54,286 @@ bool HttpContext::parseRequest(Buffer *buf, Timestamp receiveTime)
         }
         else if (state_ == kExpectHeaders)
         {
-            const char *crlf = buf->findCRLF();
-            if (crlf)
+            // 一次扫描出已到达的所有完整请求头行（行尾和冒号位置），再逐行交给状态机
+            const char *next = cursor;
+            size_t count = HeaderScanner::scan(cursor, buf->peek() + buf->readableBytes(),
+                                               lines_.data(), lines_.size(), &next);
+
+            for (size_t i = 0; i < count && ok && state_ == kExpectHeaders; ++i)
             {
-                const char *colon = std::find(buf->peek(), crlf, ':');
-                if (colon < crlf)
+                const HeaderScanner::Line &line = lines_[i];
+                if (line.colon < line.end)
                 {
-                    request_.addHeader(buf->peek(), colon, crlf);
+                    request_.addHeader(line.begin, line.colon, line.end);
                 }
-                else if (buf->peek() == crlf)
-                { 
+                else if (line.begin == line.end)
+                {
                     // 空行，结束Header
-                    // 根据请求方法和Content-Length判断是否需要继续读取body
-                    if (request_.method() == HttpRequest::kPost || 
-                        request_.method() == HttpRequest::kPut)
-                    {
-                        std::string contentLength = request_.getHeader("Content-Length");
-                        if (!contentLength.empty())
-                        {
-                            request_.setContentLength(std::stoi(contentLength));
-                            if (request_.contentLength() > 0)
-                            {
-                                state_ = kExpectBody;
-                            }
-                            else
-                            {
-                                state_ = kGotAll;
-                                hasMore = false;
-                            }
-                        }
-                        else
-                        {
-                            // POST/PUT 请求没有 Content-Length，是HTTP语法错误
-                            ok = false;
-                            hasMore = false;
-                        }
-                    }
-                    else
-                    {
-                        // GET/HEAD/DELETE 等方法直接完成（没有请求体）
-                        state_ = kGotAll; 
-                        hasMore = false;
-                    }
+                    ok = processHeadersEnd();
                 }
                 else
                 {
                     ok = false; // Header行格式错误
+                }
+            }
+
+            parsedBytes_ = next - buf->peek(); // 解析进度指向下一行数据
+            if (ok && (chunked_ || bodyCallback_) && state_ != kExpectHeaders && state_ != kGotAll)
+            {
+                // 分块编码和流式请求体都不在缓冲区中原地保留请求体，先把请求头拷贝出来
+                detachHead(buf);
+            }
+            if (!ok || state_ == kGotAll || count == 0)
+            {
+                hasMore = false;
+            }
+        }
+        else if (state_ == kExpectBody)
+        {
+            size_t avail = buf->readableBytes() - parsedBytes_;
+            if (bodyCallback_)
+            {
+                // 流式请求体：到达多少交付多少，交付后立即回收
+                size_t n = static_cast<size_t>(std::min<uint64_t>(avail, bodyRemaining_));
+                if (n > 0)
+                {
+                    deliverBody(cursor, n);
+                    buf->retrieve(parsedBytes_ + n);
+                    parsedBytes_ = 0;
+                    bodyRemaining_ -= n;
+                }
+                if (bodyRemaining_ == 0)
+                {
+                    state_ = kGotAll;
+                }
+            }
+            else if (avail >= request_.contentLength())
+            {
+                // 只读取 Content-Length 指定的长度
+                request_.setBody(cursor, cursor + request_.contentLength());
+                parsedBytes_ += request_.contentLength();
+                state_ = kGotAll;
+            }
+            // 检查缓冲区中是否有足够的数据，数据不完整则等待更多数据
+            hasMore = false;
+        }
+        else if (state_ == kExpectChunkSize || state_ == kExpectTrailers)
+        {
+            const char *crlf = buf->findCRLF(cursor);
+            if (crlf)
+            {
+                if (state_ == kExpectChunkSize)
+                {
+                    ok = processChunkSize(cursor, crlf);
+                }
+                else if (crlf == cursor)
+                {
+                    state_ = kGotAll; // 尾部字段以空行结束
+                }
+                // 尾部字段不影响请求的处理，直接跳过
+                parsedBytes_ = crlf + 2 - buf->peek();
+                if (!ok || state_ == kGotAll)
+                {
                     hasMore = false;
                 }
-                buf->retrieveUntil(crlf + 2); // 开始读指针指向下一行数据
             }
             else
             {
                 hasMore = false;
             }
         }
-        else if (state_ == kExpectBody)
+        else if (state_ == kExpectChunkData)
+        {
+            size_t avail = buf->readableBytes() - parsedBytes_;
+            size_t n = static_cast<size_t>(std::min<uint64_t>(avail, bodyRemaining_));
+            if (n > 0)
+            {
+                deliverBody(cursor, n);
+                // 请求头已经 detach，分块数据解码后即可回收，缓冲区只保留尚未解码的数据
+                buf->retrieve(parsedBytes_ + n);
+                parsedBytes_ = 0;
+                bodyRemaining_ -= n;
+            }
+            if (bodyRemaining_ == 0)
+            {
+                state_ = kExpectChunkEnd;
+            }
+            else
+            {
+                hasMore = false;
+            }
+        }
+        else if (state_ == kExpectChunkEnd)
+        {
+            if (buf->readableBytes() - parsedBytes_ >= 2)
+            {
+                ok = cursor[0] == '\r' && cursor[1] == '\n';
+                parsedBytes_ += 2;
+                state_ = kExpectChunkSize;
+                hasMore = ok;
+            }
+            else
+            {
+                hasMore = false;
+            }
+        }
+        else
+        {
+            hasMore = false;
+        }
+    }
+
+    if (base_ != nullptr)
+    {
+        request_.pin(buf->peek(), parsedBytes_);
+    }
+    if (!ok && error_ == kNoError)
+    {
+        error_ = kBadRequest;
+    }
+    return ok; // ok为false代表报文错误，错误类型见 parseError()
+}
+
+bool HttpContext::parseBodyLength(uint64_t* length, bool* hasLength)
+{
+    *hasLength = false;
+    size_t transferEncodings = 0;
+    for (const RequestHeaders::Field& field : request_.headers())
+    {
+        if (field.id == HeaderId::kTransferEncoding)
         {
-            // 检查缓冲区中是否有足够的数据
-            if (buf->readableBytes() < request_.contentLength())
+            ++transferEncodings;
+        }
+        else if (field.id == HeaderId::kContentLength)
+        {
+            uint64_t value = 0;
+            auto result = std::from_chars(field.value.data(), field.value.data() + field.value.size(), value);
+            if (field.value.empty() || result.ec != std::errc() || result.ptr != field.value.data() + field.value.size())
+            {
+                return false;
+            }
+            // 多个取值不同的 Content-Length，前后端可能各取一个
+            if (*hasLength && value != *length)
             {
-                hasMore = false; // 数据不完整，等待更多数据
-                return true;
+                return false;
             }
+            *length = value;
+            *hasLength = true;
+        }
+    }
+    // 同时带 Transfer-Encoding 和 Content-Length、或者多个 Transfer-Encoding 的报文，
+    // 代理和本服务器可能按不同的方式划分请求边界，直接拒绝
+    return transferEncodings == 0 || (transferEncodings == 1 && !*hasLength);
+}
 
-            // 只读取 Content-Length 指定的长度
-            std::string body(buf->peek(), buf->peek() + request_.contentLength());
-            request_.setBody(body);
+// 请求头结束，根据Transfer-Encoding、请求方法和Content-Length判断是否需要继续读取body
+bool HttpContext::processHeadersEnd()
+{
+    uint64_t length = 0;
+    bool hasLength = false;
+    if (!parseBodyLength(&length, &hasLength))
+    {
+        return false;
+    }
 
-            // 准确移动读指针
-            buf->retrieve(request_.contentLength());
+    std::string_view transferEncoding = request_.header(HeaderId::kTransferEncoding);
+    if (!transferEncoding.empty())
+    {
+        // 只支持 chunked 编码
+        if (!iequals(transferEncoding, "chunked"))
+        {
+            return false;
+        }
+        chunked_ = true;
+        state_ = kExpectChunkSize;
+    }
+    else if (hasLength)
+    {
+        // 任何方法带了 Content-Length 都按它读取请求体，否则请求体会被当成下一个请求
+        request_.setContentLength(length);
+        bodyRemaining_ = length;
+        state_ = length > 0 ? kExpectBody : kGotAll;
+    }
+    else if (request_.method() == HttpRequest::kPost || 
+             request_.method() == HttpRequest::kPut)
+    {
+        // POST/PUT 请求没有合法的 Content-Length，是HTTP语法错误
+        return false;
+    }
+    else
+    {
+        // GET/HEAD/DELETE 等方法直接完成（没有请求体）
+        state_ = kGotAll;
+    }
 
-            state_ = kGotAll;
-            hasMore = false;
+    if (state_ != kGotAll && bodyStreamSelector_)
+    {
+        bodyCallback_ = bodyStreamSelector_(request_);
+        request_.setBodyStreamed(static_cast<bool>(bodyCallback_));
+    }
+    // 整体缓存的请求体在读取之前就检查长度（分块编码的在每个分块长度行检查）
+    if (!bodyCallback_ && !chunked_ && length > maxBodySize_)
+    {
+        error_ = kPayloadTooLarge;
+        return false;
+    }
+    return true;
+}
+
+// 解析分块长度行：十六进制长度，后面可能带 ;扩展字段
+bool HttpContext::processChunkSize(const char *begin, const char *end)
+{
+    const char *sizeEnd = std::find(begin, end, ';');
+    while (sizeEnd > begin && (*(sizeEnd - 1) == ' ' || *(sizeEnd - 1) == '\t'))
+    {
+        --sizeEnd;
+    }
+
+    uint64_t size = 0;
+    auto result = std::from_chars(begin, sizeEnd, size, 16);
+    if (begin == sizeEnd || result.ec != std::errc() || result.ptr != sizeEnd)
+    {
+        return false;
+    }
+
+    if (size == 0)
+    {
+        state_ = kExpectTrailers; // 最后一个分块
+    }
+    else
+    {
+        // 解码后整体缓存的请求体不能超过上限，分块长度本身可以大到 2^64
+        if (!bodyCallback_ && size > maxBodySize_ - std::min(maxBodySize_, request_.contentLength()))
+        {
+            error_ = kPayloadTooLarge;
+            return false;
         }
+        request_.setContentLength(request_.contentLength() + size);
+        bodyRemaining_ = size;
+        state_ = kExpectChunkData;
+    }
+    return true;
+}
+
+void HttpContext::deliverBody(const char *data, size_t len)
+{
+    if (bodyCallback_)
+    {
+        bodyCallback_(request_, std::string_view(data, len));
+    }
+    else
+    {
+        request_.appendBody(data, len);
     }
-    return ok; // ok为false代表报文语法解析错误
+}
+
+void HttpContext::detachHead(Buffer *buf)
+{
+    request_.pin(buf->peek(), parsedBytes_);
+    request_.detach();
+    buf->retrieve(parsedBytes_);
+    parsedBytes_ = 0;
+    base_ = nullptr;
 }
 
 // 解析请求行
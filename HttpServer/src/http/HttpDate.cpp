@@ -0,0 +1,136 @@
+#include "../../include/http/HttpDate.h"
+
+#include <cstring>
+
+namespace http
+{
+
+namespace
+{
+
+const char kWeekdays[7][4] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+const char kMonths[12][4] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                              "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+inline char* putTwoDigits(char* p, int value)
+{
+    *p++ = static_cast<char>('0' + value / 10);
+    *p++ = static_cast<char>('0' + value % 10);
+    return p;
+}
+
+const char   kPrefix[] = "Date: ";
+const size_t kPrefixLength = sizeof(kPrefix) - 1;
+
+struct DateCache
+{
+    time_t seconds = -1;
+    size_t length = 0;
+    char   line[kPrefixLength + HttpDate::kLength + 2];
+};
+
+} // namespace
+
+size_t HttpDate::format(time_t seconds, char* buf)
+{
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+
+    // 不用 strftime：它依赖 locale，而且每次都要解析格式串
+    char* p = buf;
+    memcpy(p, kWeekdays[tm.tm_wday], 3);
+    p += 3;
+    *p++ = ',';
+    *p++ = ' ';
+    p = putTwoDigits(p, tm.tm_mday);
+    *p++ = ' ';
+    memcpy(p, kMonths[tm.tm_mon], 3);
+    p += 3;
+    *p++ = ' ';
+    int year = tm.tm_year + 1900;
+    p = putTwoDigits(p, year / 100);
+    p = putTwoDigits(p, year % 100);
+    *p++ = ' ';
+    p = putTwoDigits(p, tm.tm_hour);
+    *p++ = ':';
+    p = putTwoDigits(p, tm.tm_min);
+    *p++ = ':';
+    p = putTwoDigits(p, tm.tm_sec);
+    memcpy(p, " GMT", 4);
+    p += 4;
+    return p - buf;
+}
+
+std::string HttpDate::format(time_t seconds)
+{
+    char buf[kLength];
+    return std::string(buf, format(seconds, buf));
+}
+
+bool HttpDate::parse(std::string_view date, time_t* seconds)
+{
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    if (date.size() != kLength || date.substr(3, 2) != ", " || date.substr(25) != " GMT")
+    {
+        return false;
+    }
+
+    auto number = [&date](size_t pos, size_t len, int* value) {
+        *value = 0;
+        for (size_t i = pos; i < pos + len; ++i)
+        {
+            if (date[i] < '0' || date[i] > '9')
+            {
+                return false;
+            }
+            *value = *value * 10 + (date[i] - '0');
+        }
+        return true;
+    };
+
+    struct tm tm = {};
+    int year = 0;
+    if (!number(5, 2, &tm.tm_mday) || !number(12, 4, &year) ||
+        !number(17, 2, &tm.tm_hour) || !number(20, 2, &tm.tm_min) || !number(23, 2, &tm.tm_sec))
+    {
+        return false;
+    }
+    tm.tm_year = year - 1900;
+    tm.tm_mon = -1;
+    for (int i = 0; i < 12; ++i)
+    {
+        if (date.substr(8, 3) == kMonths[i])
+        {
+            tm.tm_mon = i;
+            break;
+        }
+    }
+    if (tm.tm_mon < 0)
+    {
+        return false;
+    }
+    *seconds = timegm(&tm);
+    return true;
+}
+
+std::string_view HttpDate::header()
+{
+    // 每个 IO 线程一份缓存，不需要加锁
+    static thread_local DateCache cache;
+
+    time_t now = ::time(nullptr);
+    if (now != cache.seconds)
+    {
+        char* p = cache.line;
+        memcpy(p, kPrefix, kPrefixLength);
+        p += kPrefixLength;
+        p += format(now, p);
+        *p++ = '\r';
+        *p++ = '\n';
+        cache.length = p - cache.line;
+        cache.seconds = now;
+    }
+    return std::string_view(cache.line, cache.length);
+}
+
+} // namespace http
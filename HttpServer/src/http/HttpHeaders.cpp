@@ -0,0 +1,81 @@
+#include "../../include/http/HttpHeaders.h"
+
+namespace http
+{
+
+namespace
+{
+
+// 与 HeaderId 顺序一致
+const std::string_view kHeaderNames[] = {
+    "Host",
+    "Connection",
+    "Content-Length",
+    "Content-Type",
+    "Cookie",
+    "Origin",
+    "Transfer-Encoding",
+};
+
+static_assert(sizeof(kHeaderNames) / sizeof(kHeaderNames[0]) == static_cast<size_t>(HeaderId::kCount),
+              "kHeaderNames must match HeaderId");
+
+inline char toLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+} // namespace
+
+bool iequals(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (toLower(a[i]) != toLower(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+HeaderId lookupHeaderId(std::string_view name)
+{
+    // 先按长度和首字母分派，每个名字最多比较一次
+    HeaderId candidate = HeaderId::kOther;
+    switch (name.size())
+    {
+        case 4:
+            candidate = HeaderId::kHost;
+            break;
+        case 6:
+            candidate = toLower(name[0]) == 'c' ? HeaderId::kCookie : HeaderId::kOrigin;
+            break;
+        case 10:
+            candidate = HeaderId::kConnection;
+            break;
+        case 12:
+            candidate = HeaderId::kContentType;
+            break;
+        case 14:
+            candidate = HeaderId::kContentLength;
+            break;
+        case 17:
+            candidate = HeaderId::kTransferEncoding;
+            break;
+        default:
+            return HeaderId::kOther;
+    }
+    return iequals(name, kHeaderNames[static_cast<size_t>(candidate)]) ? candidate : HeaderId::kOther;
+}
+
+std::string_view headerName(HeaderId id)
+{
+    return id < HeaderId::kCount ? kHeaderNames[static_cast<size_t>(id)] : std::string_view();
+}
+
+} // namespace http
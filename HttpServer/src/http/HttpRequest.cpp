@@ -1,5 +1,7 @@
 #include "../../include/http/HttpRequest.h"
 
+#include <cassert>
+
 namespace http
 {
 
@@ -11,7 +13,7 @@ void HttpRequest::setReceiveTime(muduo::Timestamp t)
 bool HttpRequest::setMethod(const char *start, const char *end)
 {
     assert(method_ == kInvalid);
-    std::string m(start, end); // [start, end)
+    std::string_view m(start, end - start); // [start, end)
     if (m == "GET")
     {
         method_ = kGet;
@@ -42,104 +44,180 @@ bool HttpRequest::setMethod(const char *start, const char *end)
 
 void HttpRequest::setPath(const char *start, const char *end)
 {
-    path_.assign(start, end);
+    path_ = std::string_view(start, end - start);
 }
 
-void HttpRequest::setPathParameters(const std::string &key, const std::string &value)
+std::string HttpRequest::getQueryParameters(const std::string &key) const
 {
-    pathParameters_[key] = value;
+    return std::string(queryParameter(key));
 }
 
-std::string HttpRequest::getPathParameters(const std::string &key) const
+// 这是从问号后面分割参数，只记录原始字符串，查询时再按 & 分割
+void HttpRequest::setQueryParameters(const char *start, const char *end)
 {
-    auto it = pathParameters_.find(key);
-    if (it != pathParameters_.end())
+    query_ = std::string_view(start, end - start);
+}
+
+std::string_view HttpRequest::queryParameter(std::string_view key) const
+{
+    std::string_view rest = query_;
+    std::string_view result;
+    // 按 & 分割多个参数，同名参数以最后一个为准
+    while (!rest.empty())
     {
-        return it->second;
+        size_t pos = rest.find('&');
+        std::string_view pair = rest.substr(0, pos);
+        size_t equalPos = pair.find('=');
+        if (equalPos != std::string_view::npos && pair.substr(0, equalPos) == key)
+        {
+            result = pair.substr(equalPos + 1);
+        }
+        if (pos == std::string_view::npos)
+        {
+            break;
+        }
+        rest.remove_prefix(pos + 1);
     }
-    return "";
+    return result;
 }
 
-std::string HttpRequest::getQueryParameters(const std::string &key) const
+void HttpRequest::addHeader(const char *start, const char *colon, const char *end)
 {
-    auto it = queryParameters_.find(key);
-    if (it != queryParameters_.end())
+    std::string_view key(start, colon - start);
+    ++colon;
+    while (colon < end && isspace(*colon))
+    {
+        ++colon;
+    }
+    while (end > colon && isspace(*(end - 1))) // 消除尾部空格
     {
-        return it->second;
+        --end;
     }
-    return "";
+    headers_.add(key, std::string_view(colon, end - colon));
 }
 
-// 这是从问号后面分割参数
-void HttpRequest::setQueryParameters(const char *start, const char *end)
+std::string HttpRequest::getHeader(const std::string &field) const
 {
-    std::string argumentStr(start, end);
-    std::string::size_type pos = 0;
-    std::string::size_type prev = 0;
-
-    // 按 & 分割多个参数
-    while ((pos = argumentStr.find('&', prev)) != std::string::npos)
-    {
-        std::string pair = argumentStr.substr(prev, pos - prev);
-        std::string::size_type equalPos = pair.find('=');
+    return std::string(header(field));
+}
 
-        if (equalPos != std::string::npos)
-        {
-            std::string key = pair.substr(0, equalPos);
-            std::string value = pair.substr(equalPos + 1);
-            queryParameters_[key] = value;
-        }
+void HttpRequest::setBody(const std::string &body)
+{
+    bodyStorage_ = std::make_shared<std::string>(body);
+    content_ = *bodyStorage_;
+}
 
-        prev = pos + 1;
+void HttpRequest::appendBody(const char *data, size_t len)
+{
+    if (!bodyStorage_)
+    {
+        bodyStorage_ = std::make_shared<std::string>(content_);
     }
+    bodyStorage_->append(data, len);
+    content_ = *bodyStorage_;
+}
 
-    // 处理最后一个参数
-    std::string lastPair = argumentStr.substr(prev);
-    std::string::size_type equalPos = lastPair.find('=');
-    if (equalPos != std::string::npos)
+const RequestCookies &HttpRequest::cookies() const
+{
+    if (!cookiesParsed_)
     {
-        std::string key = lastPair.substr(0, equalPos);
-        std::string value = lastPair.substr(equalPos + 1);
-        queryParameters_[key] = value;
+        cookies_.parse(headers_.get(HeaderId::kCookie));
+        cookiesParsed_ = true;
     }
+    return cookies_;
 }
 
-void HttpRequest::addHeader(const char *start, const char *colon, const char *end)
+void HttpRequest::rebase(const char *oldBase, const char *newBase)
 {
-    std::string key(start, colon);
-    ++colon;
-    while (colon < end && isspace(*colon))
+    if (oldBase == newBase)
     {
-        ++colon;
+        return;
+    }
+
+    const char *oldEnd = oldBase + length_;
+    auto shift = [oldBase, oldEnd, newBase](std::string_view &view) {
+        if (!view.empty() && view.data() >= oldBase && view.data() + view.size() <= oldEnd)
+        {
+            view = std::string_view(newBase + (view.data() - oldBase), view.size());
+        }
+    };
+
+    shift(path_);
+    shift(query_);
+    for (auto &param : pathParams_)
+    {
+        shift(param.value);
+    }
+    for (auto &field : headers_)
+    {
+        shift(field.name);
+        shift(field.value);
     }
-    std::string value(colon, end);
-    while (!value.empty() && isspace(value[value.size() - 1])) // 消除尾部空格
+    for (auto &cookie : cookies_)
     {
-        value.resize(value.size() - 1);
+        shift(cookie.name);
+        shift(cookie.value);
     }
-    headers_[key] = value;
+    shift(cookies_.remainder());
+    shift(content_);
+    base_ = newBase;
 }
 
-std::string HttpRequest::getHeader(const std::string &field) const
+void HttpRequest::detach()
 {
-    std::string result;
-    auto it = headers_.find(field);
-    if (it != headers_.end())
+    if (base_ == nullptr || (storage_ && base_ == storage_->data()))
     {
-        result = it->second;
+        return;
     }
-    return result;
+
+    storage_ = std::make_shared<const std::string>(base_, length_);
+    rebase(base_, storage_->data());
+}
+
+void HttpRequest::reset()
+{
+    method_ = kInvalid;
+    version_ = "Unknown";
+    path_ = std::string_view();
+    query_ = std::string_view();
+    pathParams_.clear();
+    receiveTime_ = muduo::Timestamp();
+    headers_.clear();
+    content_ = std::string_view();
+    contentLength_ = 0;
+    bodyStreamed_ = false;
+    base_ = nullptr;
+    length_ = 0;
+    storage_.reset();
+    bodyStorage_.reset();
+    session_.reset();
+    cookies_.clear();
+    cookiesParsed_ = false;
+    auth_ = AuthContext();
+    beforeResult_.reset();
 }
 
 void HttpRequest::swap(HttpRequest &that)
 {
     std::swap(method_, that.method_);
     std::swap(path_, that.path_);
-    std::swap(pathParameters_, that.pathParameters_);
-    std::swap(queryParameters_, that.queryParameters_);
+    std::swap(query_, that.query_);
+    std::swap(pathParams_, that.pathParams_);
     std::swap(version_, that.version_);
     std::swap(headers_, that.headers_);
     std::swap(receiveTime_, that.receiveTime_);
+    std::swap(content_, that.content_);
+    std::swap(contentLength_, that.contentLength_);
+    std::swap(bodyStreamed_, that.bodyStreamed_);
+    std::swap(base_, that.base_);
+    std::swap(length_, that.length_);
+    std::swap(storage_, that.storage_);
+    std::swap(bodyStorage_, that.bodyStorage_);
+    std::swap(session_, that.session_);
+    std::swap(cookies_, that.cookies_);
+    std::swap(cookiesParsed_, that.cookiesParsed_);
+    std::swap(auth_, that.auth_);
+    std::swap(beforeResult_, that.beforeResult_);
 }
 
 } // namespace http
\ No newline at end of file
@@ -1,40 +1,241 @@
 #include "../../include/http/HttpResponse.h"
 
+#include <cassert>
+#include <charconv>
+#include <cstring>
+
+#include "../../include/http/HttpDate.h"
+
 namespace http
 {
 
-void HttpResponse::appendToBuffer(muduo::net::Buffer* outputBuf) const
+namespace
+{
+
+struct StatusReason
 {
-    // HttpResponse封装的信息格式化输出
-    char buf[32]; 
-    // 为什么不把状态信息放入格式化字符串中，因为状态信息有长有短，不方便定义一个固定大小的内存存储
-    snprintf(buf, sizeof buf, "%s %d ", httpVersion_.c_str(), statusCode_);
-    
-    outputBuf->append(buf);
-    outputBuf->append(statusMessage_);
-    outputBuf->append("\r\n");
+    int         code;
+    const char* reason;
+};
+
+const StatusReason kStatusReasons[] = {
+    { 100, "Continue" },
+    { 200, "OK" },
+    { 201, "Created" },
+    { 204, "No Content" },
+    { 206, "Partial Content" },
+    { 301, "Moved Permanently" },
+    { 302, "Found" },
+    { 304, "Not Modified" },
+    { 400, "Bad Request" },
+    { 401, "Unauthorized" },
+    { 403, "Forbidden" },
+    { 404, "Not Found" },
+    { 405, "Method Not Allowed" },
+    { 409, "Conflict" },
+    { 413, "Payload Too Large" },
+    { 416, "Range Not Satisfiable" },
+    { 500, "Internal Server Error" },
+    { 501, "Not Implemented" },
+    { 503, "Service Unavailable" },
+};
+
+// 预先渲染好的状态行 "HTTP/1.x 200 OK\r\n"，按 [版本][状态码] 索引
+class StatusLineTable
+{
+public:
+    static const int kMaxCode = 600;
+
+    StatusLineTable()
+    {
+        for (const auto& status : kStatusReasons)
+        {
+            std::string code = std::to_string(status.code);
+            reasons_[status.code] = status.reason;
+            lines_[0][status.code] = "HTTP/1.0 " + code + " " + status.reason + "\r\n";
+            lines_[1][status.code] = "HTTP/1.1 " + code + " " + status.reason + "\r\n";
+        }
+    }
+
+    // 没有对应的状态行时返回空
+    std::string_view find(const std::string& version, int code, const std::string& message) const
+    {
+        if (code < 0 || code >= kMaxCode || reasons_[code].empty())
+        {
+            return std::string_view();
+        }
+        // 自定义的状态描述只能现场拼
+        if (!message.empty() && message != reasons_[code])
+        {
+            return std::string_view();
+        }
+        if (version == "HTTP/1.1")
+        {
+            return lines_[1][code];
+        }
+        if (version == "HTTP/1.0")
+        {
+            return lines_[0][code];
+        }
+        return std::string_view();
+    }
+
+private:
+    std::string_view reasons_[kMaxCode];
+    std::string      lines_[2][kMaxCode];
+};
+
+const StatusLineTable& statusLines()
+{
+    static const StatusLineTable table;
+    return table;
+}
+
+inline char* put(char* p, std::string_view s)
+{
+    memcpy(p, s.data(), s.size());
+    return p + s.size();
+}
+
+const std::string_view kCRLF = "\r\n";
+const std::string_view kColonSpace = ": ";
+const std::string_view kContentLengthPrefix = "Content-Length: ";
+
+} // namespace
+
+void HttpResponse::serialize(muduo::net::Buffer* outputBuf, bool withBody) const
+{
+    // 状态行：常见的版本和状态码直接取表，否则按 "版本 状态码 描述" 拼接
+    std::string_view statusLine = statusLines().find(httpVersion_, statusCode_, statusMessage_);
+    std::string customStatusLine;
+    if (statusLine.empty())
+    {
+        customStatusLine = httpVersion_ + " " + std::to_string(statusCode_) + " " + statusMessage_ + "\r\n";
+        statusLine = customStatusLine;
+    }
+
+    std::string_view connection = closeConnection_ ? std::string_view("Connection: close\r\n")
+                                                   : std::string_view("Connection: Keep-Alive\r\n");
+    std::string_view date = HttpDate::header();
+
+    // 处理函数没有显式设置 Content-Length 头时，按长度字段（或 body 长度）生成。
+    // 204 / 304 响应没有响应体，不生成
+    char lengthBuf[24];
+    size_t lengthLen = 0;
+    if (statusCode_ != k204NoContent && statusCode_ != k304NotModified &&
+        !headers_.contains(HeaderId::kContentLength))
+    {
+        uint64_t length = contentLength_ >= 0 ? static_cast<uint64_t>(contentLength_) : bodySize();
+        lengthLen = std::to_chars(lengthBuf, lengthBuf + sizeof lengthBuf, length).ptr - lengthBuf;
+    }
 
-    if (closeConnection_) // 思考一下这些地方是不是可以直接移入近headers_中
+    size_t total = statusLine.size() + connection.size() + date.size() + kCRLF.size();
+    if (withBody)
+    {
+        total += bodySize();
+    }
+    if (lengthLen > 0)
+    {
+        total += kContentLengthPrefix.size() + lengthLen + kCRLF.size();
+    }
+    for (const auto& header : headers_)
     {
-        outputBuf->append("Connection: close\r\n");
+        total += header.name.size() + kColonSpace.size() + header.value.size() + kCRLF.size();
     }
-    else
+    for (std::string_view block : rawHeaders_)
     {
-        //snprintf(buf, sizeof buf, "Content-Length: %zd\r\n", body_.size());
-        //outputBuf->append(buf);
-        outputBuf->append("Connection: Keep-Alive\r\n");
+        total += block.size();
     }
 
+    outputBuf->ensureWritableBytes(total);
+    char* begin = outputBuf->beginWrite();
+    char* p = begin;
+    p = put(p, statusLine);
+    p = put(p, connection);
+    p = put(p, date);
+    if (lengthLen > 0)
+    {
+        p = put(p, kContentLengthPrefix);
+        p = put(p, std::string_view(lengthBuf, lengthLen));
+        p = put(p, kCRLF);
+    }
     for (const auto& header : headers_)
-    { // 为什么这里不用格式化字符串？因为key和value的长度不定
-        outputBuf->append(header.first);
-        outputBuf->append(": "); 
-        outputBuf->append(header.second);
-        outputBuf->append("\r\n");
-    }
-    outputBuf->append("\r\n");
-    
-    outputBuf->append(body_);
+    {
+        p = put(p, header.name);
+        p = put(p, kColonSpace);
+        p = put(p, header.value);
+        p = put(p, kCRLF);
+    }
+    for (std::string_view block : rawHeaders_)
+    {
+        p = put(p, block);
+    }
+    p = put(p, kCRLF);
+    if (withBody)
+    {
+        if (isSegmented())
+        {
+            for (std::string_view segment : segments_)
+            {
+                p = put(p, segment);
+            }
+        }
+        else
+        {
+            p = put(p, body());
+        }
+    }
+    assert(static_cast<size_t>(p - begin) == total);
+    outputBuf->hasWritten(p - begin);
+}
+
+void HttpResponse::addVary(std::string_view field)
+{
+    std::string_view vary = headers_.get("Vary");
+    if (vary.empty())
+    {
+        headers_.set("Vary", field);
+        return;
+    }
+
+    // 按逗号分隔的字段名逐个比较（不区分大小写），"Accept" 不能被 "Accept-Encoding" 当成已存在
+    for (std::string_view rest = vary; !rest.empty(); )
+    {
+        size_t comma = rest.find(',');
+        std::string_view token = rest.substr(0, comma);
+        while (!token.empty() && (token.front() == ' ' || token.front() == '\t'))
+        {
+            token.remove_prefix(1);
+        }
+        while (!token.empty() && (token.back() == ' ' || token.back() == '\t'))
+        {
+            token.remove_suffix(1);
+        }
+        if (token == "*" || iequals(token, field))
+        {
+            return;
+        }
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+    }
+    headers_.set("Vary", std::string(vary) + ", " + std::string(field));
+}
+
+size_t HttpResponse::bodySize() const
+{
+    if (isFile_)
+    {
+        return fileLength_;
+    }
+    if (isSegmented())
+    {
+        size_t size = 0;
+        for (std::string_view segment : segments_)
+        {
+            size += segment.size();
+        }
+        return size;
+    }
+    return body().size();
 }
 
 void HttpResponse::setStatusLine(const std::string& version,
@@ -46,4 +247,4 @@ void HttpResponse::setStatusLine(const std::string& version,
     statusMessage_ = statusMessage;
 }
 
-} // namespace http
\ No newline at end of file
+} // namespace http
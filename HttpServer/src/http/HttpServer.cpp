@@ -1,6 +1,10 @@
 #include "../../include/http/HttpServer.h"
 
+#include <errno.h>
+
+#include <algorithm>
 #include <any>
+#include <cstring>
 #include <functional>
 #include <memory>
 
@@ -22,6 +26,7 @@ HttpServer::HttpServer(int port,
     : listenAddr_(port)
     , server_(&mainLoop_, listenAddr_, name, option)
     , useSSL_(useSSL)
+    , maxBodySize_(HttpContext::kDefaultMaxBodySize)
     , httpCallback_(std::bind(&HttpServer::handleRequest, this, std::placeholders::_1, std::placeholders::_2))
 {
     initialize();
@@ -36,6 +41,15 @@ void HttpServer::start()
         LOG_ERROR << "SSL enabled but sslCtx_ not initialized. Call setSslConfig() before start().";
         abort();
     }
+    if (workerPool_)
+    {
+        workerPool_->start();
+    }
+    if (sessionManager_)
+    {
+        // 每秒清理一次过期会话（推进会话存储的时间轮）
+        mainLoop_.runEvery(1.0, [this] { sessionManager_->cleanExpiredSessions(); });
+    }
     server_.start();
     mainLoop_.loop();
 }
@@ -50,6 +64,8 @@ void HttpServer::initialize()
                   std::placeholders::_1,
                   std::placeholders::_2,
                   std::placeholders::_3));
+    server_.setWriteCompleteCallback(
+        std::bind(&HttpServer::onWriteComplete, this, std::placeholders::_1));
 }
 
 void HttpServer::setSslConfig(const ssl::SslConfig& config)
@@ -69,7 +85,11 @@ void HttpServer::onConnection(const muduo::net::TcpConnectionPtr& conn)
 {
     if (conn->connected())
     {
-        conn->setContext(HttpContext());
+        HttpContext context;
+        // 请求头解析完成后，根据路由判断处理器是否要流式接收请求体
+        context.setBodyStreamSelector([this](HttpRequest& req) { return selectBodyStream(req); });
+        context.setMaxBodySize(maxBodySize_);
+        conn->setContext(context);
         if (useSSL_)
         {
             if (!sslCtx_)
@@ -141,55 +161,232 @@ void HttpServer::onMessage(const muduo::net::TcpConnectionPtr &conn,
             return;
         }
         
-        // Support handling multiple complete requests within a single callback.
-        while (buf->readableBytes() > 0)
+        processRequests(conn, context, buf, receiveTime);
+    }
+    catch (const std::exception &e)
+    {
+        // 捕获异常，返回错误信息
+        LOG_ERROR << "Exception in onMessage: " << e.what();
+        sendErrorAndClose(conn, boost::any_cast<HttpContext>(conn->getMutableContext()));
+    }
+}
+
+// 依次处理 buf 中所有完整的请求
+void HttpServer::processRequests(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                                 muduo::net::Buffer* buf, muduo::Timestamp receiveTime)
+{
+    // Support handling multiple complete requests within a single callback.
+    while (buf->readableBytes() > 0)
+    {
+        // 文件响应还没发完（sendFile），或者请求还在工作线程中处理（dispatchToWorker），
+        // 后续请求等前一个响应发出后再处理
+        if (context->fileTransfer() || context->responsePending())
+        {
+            break;
+        }
+
+        if (!context->parseRequest(buf, receiveTime))
         {
-            if (!context->parseRequest(buf, receiveTime))
+            sendErrorAndClose(conn, context, context->parseError());
+            return;
+        }
+
+        if (context->gotAll())
+        {
+            // 静态路由在 IO 线程中同步执行，命中时不必再查动态路由的基数树
+            const router::Router::Route* route =
+                isStaticRoute(context->request()) ? nullptr : router_.match(context->request());
+            if (route && route->asyncCallback)
             {
-                conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-                conn->shutdown();
-                return;
+                dispatchAsync(conn, context, route);
             }
-
-            if (context->gotAll())
+            else if (workerPool_ && route && route->blocking)
             {
-                onRequest(conn, context->request());
-                context->reset();
-                // 继续循环，看 buf 里是否还有下一个请求
+                // 请求拷贝出私有数据后投递，缓冲区中的数据可以直接回收
+                dispatchToWorker(conn, context);
             }
             else
             {
-                // 还没凑够一个完整 HTTP 请求
-                break;
+                onRequest(conn, context);
             }
+            // 响应已经发出，请求引用的输入数据可以回收了
+            buf->retrieve(context->requestBytes());
+            context->reset();
+            // 继续循环，看 buf 里是否还有下一个请求
+        }
+        else
+        {
+            // 还没凑够一个完整 HTTP 请求
+            break;
         }
     }
+    // 本次处理的所有响应一次写出
+    flushResponses(conn, context);
+}
+
+// 前一个响应（文件、工作线程）发出后，继续处理留在输入缓冲区中的后续请求
+void HttpServer::resumeRequests(const muduo::net::TcpConnectionPtr& conn, HttpContext* context)
+{
+    if (!conn->connected() || context->fileTransfer() || context->responsePending())
+    {
+        return;
+    }
+
+    muduo::net::Buffer* buf = conn->inputBuffer();
+    if (useSSL_)
+    {
+        auto it = sslConns_.find(conn);
+        if (it == sslConns_.end())
+        {
+            return;
+        }
+        buf = it->second->getDecryptedBuffer();
+    }
+    if (buf->readableBytes() == 0)
+    {
+        return;
+    }
+
+    try
+    {
+        processRequests(conn, context, buf, muduo::Timestamp::now());
+    }
     catch (const std::exception &e)
     {
-        // 捕获异常，返回错误信息
-        LOG_ERROR << "Exception in onMessage: " << e.what();
-        conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-        conn->shutdown();
+        LOG_ERROR << "Exception in resumeRequests: " << e.what();
+        sendErrorAndClose(conn, context);
     }
 }
 
-void HttpServer::onRequest(const muduo::net::TcpConnectionPtr &conn, const HttpRequest &req)
+bool HttpServer::shouldClose(const HttpRequest& req)
+{
+    std::string_view connection = req.header(HeaderId::kConnection);
+    return iequals(connection, "close") ||
+           (req.getVersion() == "HTTP/1.0" && !iequals(connection, "Keep-Alive"));
+}
+
+void HttpServer::onRequest(const muduo::net::TcpConnectionPtr &conn, HttpContext* context)
 {
-    const std::string &connection = req.getHeader("Connection");
-    bool close = ((connection == "close") ||
-                  (req.getVersion() == "HTTP/1.0" && connection != "Keep-Alive"));
-    HttpResponse response(close);
+    HttpRequest& req = context->request();
+    HttpResponse response(shouldClose(req));
 
     // 根据请求报文信息来封装响应报文对象
     httpCallback_(req, &response); // 执行onHttpCallback函数
 
-    // 可以给response设置一个成员，判断是否请求的是文件，如果是文件设置为true，并且存在文件位置在这里send出去。
-    muduo::net::Buffer buf;
-    response.appendToBuffer(&buf);
-    // 打印完整的响应内容用于调试
-    LOG_INFO << "Sending response:\n" << buf.toStringPiece().as_string();
+    sendResponse(conn, response, context);
+}
+
+// 把阻塞的请求投递到工作线程池：中间件、路由和压缩都在工作线程中执行，
+// 生成的响应通过 runInLoop 回到连接所属的 IO 线程发送。
+// 响应发出之前连接上的后续请求不会被处理，流水线请求的响应顺序不变
+void HttpServer::dispatchToWorker(const muduo::net::TcpConnectionPtr& conn, HttpContext* context)
+{
+    auto req = std::make_shared<HttpRequest>();
+    req->swap(context->request());
+    req->detach();
+    auto resp = std::make_shared<HttpResponse>(shouldClose(*req));
+
+    context->setResponsePending(true);
+    bool posted = workerPool_->post([this, conn, req, resp]() {
+        httpCallback_(*req, resp.get());
+        conn->getLoop()->runInLoop([this, conn, resp]() {
+            onAsyncResponse(conn, *resp);
+        });
+    });
+    if (!posted)
+    {
+        // 排队的请求已达上限，直接拒绝，不让积压继续增长
+        LOG_WARN << "WorkerPool is full, reject " << req->path();
+        context->setResponsePending(false);
+        HttpResponse busy(resp->closeConnection());
+        busy.setStatusCode(HttpResponse::k503ServiceUnavailable);
+        busy.setStatusMessage("Service Unavailable");
+        busy.addHeader("Retry-After", "1");
+        sendResponse(conn, busy, context);
+    }
+}
+
+// 请求拷贝出私有数据后启动协程。协程第一次挂起（或直接结束）时返回这里，
+// 之后由 awaitable 在本 IO 线程中恢复执行
+void HttpServer::dispatchAsync(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                               const router::Router::Route* route)
+{
+    auto req = std::make_shared<HttpRequest>();
+    req->swap(context->request());
+    req->detach();
+
+    context->setResponsePending(true);
+    runAsync(conn, std::move(req), route);
+}
+
+async::Detached HttpServer::runAsync(muduo::net::TcpConnectionPtr conn, std::shared_ptr<HttpRequest> req,
+                                     const router::Router::Route* route)
+{
+    HttpResponse response(shouldClose(*req));
+    try
+    {
+        size_t depth = 0;
+        if (middlewareChain_.processBefore(*req, response, &depth) &&
+            router::Router::authorize(*route, *req, &response))
+        {
+            co_await route->asyncCallback(*req, &response);
+            router::Router::applyCacheControl(*route, &response);
+            // 会话修改在请求结束时统一保存一次
+            if (sessionManager_)
+            {
+                sessionManager_->commit(*req, &response);
+            }
+        }
+        middlewareChain_.processAfter(*req, response, depth);
+        if (compressionStage_)
+        {
+            compressionStage_->process(*req, response);
+        }
+    }
+    catch (const async::WorkerPoolFull&)
+    {
+        response.setStatusCode(HttpResponse::k503ServiceUnavailable);
+        response.setStatusMessage("Service Unavailable");
+        response.addHeader("Retry-After", "1");
+        response.setBody(std::string());
+    }
+    catch (const std::exception& e)
+    {
+        response.setStatusCode(HttpResponse::k500InternalServerError);
+        response.setBody(e.what());
+    }
+    onAsyncResponse(conn, response);
+}
+
+void HttpServer::onAsyncResponse(const muduo::net::TcpConnectionPtr& conn, HttpResponse& response)
+{
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+    if (context == nullptr || !conn->connected())
+    {
+        // 处理期间连接已经断开
+        return;
+    }
+    context->setResponsePending(false);
+    sendResponse(conn, response, context);
+    flushResponses(conn, context);
+    // 协程没有挂起就结束时还在 processRequests 的循环中（当前请求尚未从缓冲区回收），
+    // 不能在这里重入，留到下一轮事件循环处理
+    conn->getLoop()->queueInLoop([this, conn]() {
+        HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+        if (context)
+        {
+            resumeRequests(conn, context);
+        }
+    });
+}
 
-    auto piece = buf.toStringPiece();
+// 响应追加到连接的输出批次（HttpContext::outputBatch），由 flushResponses 一次写出：
+// 同一次 onMessage 中处理的多个（流水线）请求的响应合并成一次 write，TLS 连接合并成一次 SSL_write。
+// 需要直接写套接字的情况（大段响应体、文件、关闭连接）先写出批次中已有的数据，保证顺序
+void HttpServer::sendResponse(const muduo::net::TcpConnectionPtr &conn, HttpResponse &response,
+                              HttpContext* context)
+{
+    muduo::net::Buffer* out = context->outputBatch();
     if (useSSL_)
     {
         auto it = sslConns_.find(conn);
@@ -199,28 +396,244 @@ void HttpServer::onRequest(const muduo::net::TcpConnectionPtr &conn, const HttpR
             conn->shutdown();
             return;
         }
-        it->second->send(piece.data(), piece.size());
     }
-    else
+
+    if (response.isFile())
+    {
+        if (!useSSL_)
+        {
+            // 明文连接：先发响应头，文件内容分块读出后发送（见 sendFile）
+            response.appendHeadersToBuffer(out);
+            flushResponses(conn, context);
+
+            auto transfer = std::make_shared<HttpContext::FileTransfer>();
+            transfer->file = response.file();
+            transfer->offset = static_cast<off_t>(response.fileOffset());
+            transfer->end = transfer->offset + static_cast<off_t>(response.fileLength());
+            transfer->closeAfter = response.closeConnection();
+            context->setFileTransfer(transfer);
+            sendFile(conn, context);
+            return;
+        }
+        // TLS 连接要经过 SSL_write 加密，读入内存后按普通响应体发送
+        std::string content;
+        if (!response.file()->readRange(response.fileOffset(), response.fileLength(), &content))
+        {
+            flushResponses(conn, context);
+            conn->shutdown();
+            return;
+        }
+        response.setBody(std::move(content));
+    }
+
+    // 响应体按段发送：小段（不超过 kInlineBodyLimit）拷贝到响应头后面合并发送，一次写比多次系统调用划算；
+    // 大段不拷贝，先发出已合并的数据再直接发送该段。在 IO 线程内 TcpConnection::send 输出缓冲区为空时直接 write，
+    // 只有没写完的部分才会进入输出缓冲区
+    std::string_view single = response.body();
+    const std::string_view* first = &single;
+    const std::string_view* last = &single + 1;
+    if (response.isSegmented())
+    {
+        first = response.segments().data();
+        last = first + response.segments().size();
+    }
+
+    size_t headStart = out->readableBytes();
+    response.appendHeadersToBuffer(out);
+    // 打印完整的响应头用于调试
+    LOG_INFO << "Sending response:\n" << std::string(out->peek() + headStart, out->readableBytes() - headStart);
+
+    size_t inlineBytes = 0;
+    for (const std::string_view* segment = first; segment != last; ++segment)
+    {
+        if (segment->size() <= kInlineBodyLimit)
+        {
+            inlineBytes += segment->size();
+        }
+    }
+    out->ensureWritableBytes(inlineBytes);
+
+    for (const std::string_view* segment = first; segment != last; ++segment)
+    {
+        if (segment->size() <= kInlineBodyLimit)
+        {
+            out->append(segment->data(), segment->size());
+            continue;
+        }
+        flushResponses(conn, context);
+        sendData(conn, segment->data(), segment->size());
+    }
+
+    // 如果是短连接的话，返回响应报文后就断开连接；批次过大时提前写出，避免长时间占用内存
+    if (response.closeConnection() || out->readableBytes() >= kBatchFlushBytes)
     {
-        conn->send(&buf);
+        flushResponses(conn, context);
     }
-    // 如果是短连接的话，返回响应报文后就断开连接
     if (response.closeConnection())        
         conn->shutdown();
 }
 
+void HttpServer::flushResponses(const muduo::net::TcpConnectionPtr& conn, HttpContext* context)
+{
+    muduo::net::Buffer* out = context->outputBatch();
+    if (out->readableBytes() > 0)
+    {
+        sendData(conn, out->peek(), out->readableBytes());
+        out->retrieveAll();
+    }
+}
+
+void HttpServer::sendErrorAndClose(const muduo::net::TcpConnectionPtr& conn, HttpContext* context,
+                                   HttpContext::ParseError error)
+{
+    static const std::string_view kBadRequest =
+        "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    static const std::string_view kPayloadTooLarge =
+        "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    if (context != nullptr)
+    {
+        flushResponses(conn, context);
+    }
+    // 经过 sendData：SSL 连接上的错误响应也要加密
+    std::string_view response = error == HttpContext::kPayloadTooLarge ? kPayloadTooLarge : kBadRequest;
+    sendData(conn, response.data(), response.size());
+    conn->shutdown();
+}
+
+void HttpServer::sendData(const muduo::net::TcpConnectionPtr& conn, const char* data, size_t len)
+{
+    if (useSSL_)
+    {
+        // 一次 SSL_write 把整批数据加密成尽量少的 TLS 记录，再一次写到 TCP
+        auto it = sslConns_.find(conn);
+        if (it != sslConns_.end())
+        {
+            it->second->send(data, len);
+        }
+    }
+    else
+    {
+        conn->send(data, static_cast<int>(len));
+    }
+}
+
+void HttpServer::onWriteComplete(const muduo::net::TcpConnectionPtr& conn)
+{
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+    if (context && context->fileTransfer())
+    {
+        sendFile(conn, context);
+        // 文件发送完成后处理发送期间留在输入缓冲区中的后续请求。
+        // 在 sendResponse 中同步发送完的情况由 processRequests 的循环继续处理，不能在 sendFile 里重入
+        resumeRequests(conn, context);
+    }
+}
+
+// 继续发送文件响应：每次读出一块（最多 kFileChunkSize）交给 TcpConnection::send，
+// 写完后由 onWriteComplete 再回到这里发送下一块。输出缓冲区里最多只有一块文件数据，大文件不会堆积在内存中，
+// 单个大文件也不会长时间占用 IO 线程
+void HttpServer::sendFile(const muduo::net::TcpConnectionPtr& conn, HttpContext* context)
+{
+    std::shared_ptr<HttpContext::FileTransfer> transfer = context->fileTransfer();
+    // 响应头或上一块数据还在输出缓冲区中，等它写完
+    if (!transfer || conn->outputBuffer()->readableBytes() > 0)
+    {
+        return;
+    }
+
+    const FileBody& file = *transfer->file;
+    if (transfer->offset < transfer->end)
+    {
+        size_t len = std::min(static_cast<size_t>(transfer->end - transfer->offset), kFileChunkSize);
+        // 读缓冲区放在 FileTransfer 中复用，不占用 IO 线程的栈
+        muduo::net::Buffer& chunk = transfer->chunk;
+        chunk.ensureWritableBytes(len);
+        ssize_t n;
+        do
+        {
+            n = file.read(transfer->offset, chunk.beginWrite(), len);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0)
+        {
+            LOG_ERROR << "read " << file.path() << " failed, errno=" << errno;
+            context->setFileTransfer(nullptr);
+            conn->forceClose();
+            return;
+        }
+        chunk.hasWritten(static_cast<size_t>(n));
+        transfer->offset += n;
+        conn->send(&chunk);
+        if (transfer->offset < transfer->end)
+        {
+            return;
+        }
+    }
+
+    context->setFileTransfer(nullptr);
+    if (transfer->closeAfter)
+    {
+        conn->shutdown();
+    }
+}
+
+// 处理器要流式接收请求体时，数据在请求完整之前就会交给处理器，所以前置中间件（CORS、鉴权）和
+// 路由的登录检查要在请求头到达时先执行。被拒绝的请求仍然读完请求体（保持连接上的报文边界），
+// 但数据直接丢弃，请求完整后发送拒绝时生成的响应
+HttpContext::BodyCallback HttpServer::selectBodyStream(HttpRequest& req)
+{
+    if (isStaticRoute(req))
+    {
+        return nullptr;
+    }
+    const router::Router::Route* route = router_.match(req);
+    if (!route || !route->handler || !route->handler->streamBody())
+    {
+        return nullptr;
+    }
+
+    auto result = std::make_shared<HttpRequest::BeforeResult>();
+    auto response = std::make_shared<HttpResponse>(shouldClose(req));
+    bool passed = middlewareChain_.processBefore(req, *response, &result->depth) &&
+                  router::Router::authorize(*route, req, response.get());
+    if (!passed)
+    {
+        result->rejection = std::move(response);
+    }
+    req.setBeforeResult(result);
+    if (!passed)
+    {
+        return [](const HttpRequest&, std::string_view) {};
+    }
+    router::Router::HandlerPtr handler = route->handler;
+    return [handler](const HttpRequest& request, std::string_view chunk) {
+        handler->onBodyChunk(request, chunk);
+    };
+}
+
 // 执行请求对应的路由处理函数
-void HttpServer::handleRequest(const HttpRequest &req, HttpResponse *resp)
+void HttpServer::handleRequest(HttpRequest &req, HttpResponse *resp)
 {
     try
     {
-        // 处理请求前的中间件
-        HttpRequest mutableReq = req;
-        middlewareChain_.processBefore(mutableReq);
-
-        // 路由处理
-        if (!router_.route(mutableReq, resp))
+        // 处理请求前的中间件，中间件可以直接生成响应（如CORS预检请求）。
+        // 流式请求体的请求已经在请求头到达时执行过（selectBodyStream）
+        size_t depth = 0;
+        bool proceed = true;
+        if (const auto& before = req.beforeResult())
+        {
+            depth = before->depth;
+            if (before->rejection)
+            {
+                *resp = *before->rejection;
+                proceed = false;
+            }
+        }
+        else
+        {
+            proceed = middlewareChain_.processBefore(req, *resp, &depth);
+        }
+        if (proceed &&
+            !routeStatic(req, resp) && !router_.route(req, resp))
         {
             LOG_INFO << "请求的啥，url：" << req.method() << " " << req.path();
             LOG_INFO << "未找到路由，返回404";
@@ -228,14 +641,20 @@ void HttpServer::handleRequest(const HttpRequest &req, HttpResponse *resp)
             resp->setStatusMessage("Not Found");
             resp->setCloseConnection(true);
         }
+        // 会话修改在请求结束时统一保存一次
+        if (sessionManager_)
+        {
+            sessionManager_->commit(req, resp);
+        }
 
         // 处理响应后的中间件
-        middlewareChain_.processAfter(*resp);
-    }
-    catch (const HttpResponse& res) 
-    {
-        // 处理中间件抛出的响应（如CORS预检请求）
-        *resp = res;
+        middlewareChain_.processAfter(req, *resp, depth);
+
+        // 响应压缩
+        if (compressionStage_)
+        {
+            compressionStage_->process(req, *resp);
+        }
     }
     catch (const std::exception& e) 
     {
@@ -0,0 +1,519 @@
+#include "../../include/http/StaticFileCache.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <muduo/base/Logging.h>
+
+#include "../../include/http/FileBody.h"
+#include "../../include/http/HttpDate.h"
+#include "../../include/http/StaticResource.h"
+#include "../../include/utils/CompressUtil.h"
+
+namespace http
+{
+
+namespace
+{
+
+struct MimeType
+{
+    const char* extension;
+    const char* type;
+};
+
+const MimeType kMimeTypes[] = {
+    { "html", "text/html" },
+    { "htm",  "text/html" },
+    { "css",  "text/css" },
+    { "js",   "application/javascript" },
+    { "json", "application/json" },
+    { "txt",  "text/plain" },
+    { "png",  "image/png" },
+    { "jpg",  "image/jpeg" },
+    { "jpeg", "image/jpeg" },
+    { "gif",  "image/gif" },
+    { "svg",  "image/svg+xml" },
+    { "ico",  "image/x-icon" },
+    { "woff2", "font/woff2" },
+};
+
+std::string mimeTypeOf(const std::string& path)
+{
+    size_t dot = path.rfind('.');
+    if (dot != std::string::npos && path.find('/', dot) == std::string::npos)
+    {
+        std::string_view extension(path.c_str() + dot + 1, path.size() - dot - 1);
+        for (const auto& mime : kMimeTypes)
+        {
+            if (iequals(extension, mime.extension))
+            {
+                return mime.type;
+            }
+        }
+    }
+    return "application/octet-stream";
+}
+
+const size_t kDefaultMemoryLimit = 64 * 1024 * 1024;
+const size_t kMinPrecompressSize = 256;
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                            IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// 压缩结果没有变小时返回空
+std::shared_ptr<const std::string> precompress(const std::string& content, bool brotli)
+{
+    auto compressed = std::make_shared<std::string>();
+    bool ok = brotli ? CompressUtil::brotli(content, 11, compressed.get())
+                     : CompressUtil::gzip(content, 9, compressed.get());
+    if (!ok || compressed->size() >= content.size())
+    {
+        return nullptr;
+    }
+    return compressed;
+}
+
+size_t entrySize(const StaticFileCache::Entry& entry)
+{
+    return entry.content->size() +
+           (entry.gzipContent ? entry.gzipContent->size() : 0) +
+           (entry.brotliContent ? entry.brotliContent->size() : 0);
+}
+
+} // namespace
+
+StaticFileCache::StaticFileCache()
+    : memoryUsage_(0)
+    , memoryLimit_(kDefaultMemoryLimit)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0)
+    , inotifyFd_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , running_(false)
+    , compressStopping_(false)
+{
+    shards_.reserve(kShardCount);
+    for (size_t i = 0; i < kShardCount; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    compressThread_ = std::thread(&StaticFileCache::precompressLoop, this);
+    if (inotifyFd_ < 0)
+    {
+        LOG_ERROR << "inotify_init1 failed, errno=" << errno << ", static file cache will not be refreshed";
+    }
+}
+
+StaticFileCache::~StaticFileCache()
+{
+    running_ = false;
+    if (watchThread_.joinable())
+    {
+        watchThread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(compressMutex_);
+        compressStopping_ = true;
+    }
+    compressCond_.notify_one();
+    compressThread_.join();
+    if (inotifyFd_ >= 0)
+    {
+        ::close(inotifyFd_);
+    }
+}
+
+void StaticFileCache::setMemoryLimit(size_t bytes)
+{
+    memoryLimit_ = bytes;
+    evict();
+}
+
+bool StaticFileCache::watch(const std::string& dir)
+{
+    if (inotifyFd_ < 0)
+    {
+        return false;
+    }
+
+    std::string path(dir);
+    while (path.size() > 1 && path.back() == '/')
+    {
+        path.pop_back();
+    }
+
+    if (!addWatch(path))
+    {
+        LOG_ERROR << "inotify_add_watch " << dir << " failed, errno=" << errno;
+        return false;
+    }
+    if (!running_.exchange(true))
+    {
+        watchThread_ = std::thread(&StaticFileCache::watchLoop, this);
+    }
+    return true;
+}
+
+StaticFileCache::Shard& StaticFileCache::shardFor(const std::string& path)
+{
+    return *shards_[std::hash<std::string>()(path) % kShardCount];
+}
+
+StaticFileCache::EntryPtr StaticFileCache::get(const std::string& path)
+{
+    Shard& shard = shardFor(path);
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(path);
+        if (it != shard.entries.end())
+        {
+            ++hits_;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+            return it->second.entry;
+        }
+        generation = shard.generation;
+    }
+
+    // 读盘不持锁，其他线程的命中不受影响；预压缩在放入缓存后由后台线程进行
+    ++misses_;
+    EntryPtr entry = load(path);
+    if (!entry)
+    {
+        return nullptr;
+    }
+
+    size_t size = entrySize(*entry);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // 读盘期间文件发生了变化，读到的可能是旧内容，只用于这一次响应
+        if (shard.generation != generation || size > memoryLimit_)
+        {
+            return entry;
+        }
+        auto it = shard.entries.find(path);
+        if (it != shard.entries.end())
+        {
+            // 其他线程同时加载了同一个文件
+            memoryUsage_ -= entrySize(*it->second.entry);
+            it->second.entry = entry;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+        }
+        else
+        {
+            shard.lru.push_front(path);
+            shard.entries[path] = Slot{ entry, shard.lru.begin() };
+        }
+        memoryUsage_ += size;
+        evictLocked(shard);
+    }
+    // 本分片只剩新条目时仍然超出上限，再淘汰其他分片
+    evict();
+    if (entry->precompressPending)
+    {
+        schedulePrecompress(path, entry);
+    }
+    return entry;
+}
+
+bool StaticFileCache::serve(const HttpRequest& req, const std::string& path, HttpResponse* resp)
+{
+    EntryPtr entry = get(path);
+    if (!entry)
+    {
+        return false;
+    }
+    resp->setContentType(entry->mimeType);
+
+    StaticResource::Validators validators{ entry->etag, entry->mtime, entry->lastModified };
+    StaticResource::RangeStatus status = StaticResource::kFull;
+    size_t first = 0;
+    size_t last = 0;
+    if (!StaticResource::prepare(req, validators, entry->content->size(), resp, &status, &first, &last))
+    {
+        return true;
+    }
+    if (status == StaticResource::kFull)
+    {
+        resp->setBody(entry->content);
+        resp->setPrecompressed(entry->gzipContent, entry->brotliContent);
+        // 预压缩版本生成之前先发送原文
+        resp->setLiveCompression(!entry->precompressPending);
+    }
+    else if (status == StaticResource::kPartial)
+    {
+        // 区间直接引用缓存内容
+        std::string_view content(*entry->content);
+        resp->setBody(entry->content, { content.substr(first, last - first + 1) });
+    }
+    return true;
+}
+
+void StaticFileCache::invalidate(const std::string& path)
+{
+    Shard& shard = shardFor(path);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 即使还没有缓存也要递增，正在加载这个文件的线程据此丢弃读到的内容
+    ++shard.generation;
+    auto it = shard.entries.find(path);
+    if (it != shard.entries.end())
+    {
+        memoryUsage_ -= entrySize(*it->second.entry);
+        shard.lru.erase(it->second.lru);
+        shard.entries.erase(it);
+    }
+}
+
+size_t StaticFileCache::memoryUsage() const
+{
+    return memoryUsage_;
+}
+
+StaticFileCache::EntryPtr StaticFileCache::load(const std::string& path)
+{
+    std::shared_ptr<const FileBody> file = FileBody::open(path);
+    if (!file)
+    {
+        return nullptr;
+    }
+    auto content = std::make_shared<std::string>();
+    if (!file->readAll(content.get()))
+    {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->etag = file->etag();
+    entry->lastModified = HttpDate::format(file->lastModified());
+    entry->mimeType = mimeTypeOf(path);
+    entry->mtime = file->lastModified();
+    if (entry->mimeType == "text/html" && content->find("{{") != std::string::npos)
+    {
+        entry->htmlTemplate = HtmlTemplate::compile(content);
+    }
+    entry->precompressPending = content->size() >= kMinPrecompressSize && CompressUtil::compressible(entry->mimeType);
+    entry->content = std::move(content);
+    LOG_INFO << "static file cached: " << path << " (" << entry->content->size() << " bytes)";
+    return entry;
+}
+
+void StaticFileCache::evictLocked(Shard& shard)
+{
+    // 刚放入的条目在 LRU 头部，留到最后
+    while (memoryUsage_ > memoryLimit_ && shard.lru.size() > 1)
+    {
+        auto it = shard.entries.find(shard.lru.back());
+        memoryUsage_ -= entrySize(*it->second.entry);
+        shard.entries.erase(it);
+        shard.lru.pop_back();
+        ++evictions_;
+    }
+}
+
+void StaticFileCache::evict()
+{
+    // 各分片的 LRU 互相独立，这里只是近似的全局 LRU：轮流淘汰各分片最久未使用的条目
+    bool evicted = true;
+    while (memoryUsage_ > memoryLimit_ && evicted)
+    {
+        evicted = false;
+        for (const std::unique_ptr<Shard>& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            if (memoryUsage_ <= memoryLimit_)
+            {
+                return;
+            }
+            if (!shard->lru.empty())
+            {
+                auto it = shard->entries.find(shard->lru.back());
+                memoryUsage_ -= entrySize(*it->second.entry);
+                shard->entries.erase(it);
+                shard->lru.pop_back();
+                ++evictions_;
+                evicted = true;
+            }
+        }
+    }
+}
+
+void StaticFileCache::flushAll()
+{
+    for (const std::unique_ptr<Shard>& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        ++shard->generation;
+        for (const auto& item : shard->entries)
+        {
+            memoryUsage_ -= entrySize(*item.second.entry);
+        }
+        shard->entries.clear();
+        shard->lru.clear();
+    }
+}
+
+void StaticFileCache::schedulePrecompress(const std::string& path, const EntryPtr& entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(compressMutex_);
+        compressQueue_.emplace_back(path, entry);
+    }
+    compressCond_.notify_one();
+}
+
+void StaticFileCache::precompressLoop()
+{
+    while (true)
+    {
+        std::pair<std::string, EntryPtr> task;
+        {
+            std::unique_lock<std::mutex> lock(compressMutex_);
+            compressCond_.wait(lock, [this] { return compressStopping_ || !compressQueue_.empty(); });
+            if (compressStopping_)
+            {
+                return;
+            }
+            task = std::move(compressQueue_.front());
+            compressQueue_.pop_front();
+        }
+
+        const EntryPtr& entry = task.second;
+        auto updated = std::make_shared<Entry>(*entry);
+        updated->gzipContent = precompress(*entry->content, false);
+        updated->brotliContent = precompress(*entry->content, true);
+        updated->precompressPending = false;
+
+        // 只替换仍在缓存中的同一个条目；期间文件变化、被淘汰时丢弃结果
+        Shard& shard = shardFor(task.first);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(task.first);
+            if (it == shard.entries.end() || it->second.entry != entry)
+            {
+                continue;
+            }
+            memoryUsage_ -= entrySize(*entry);
+            memoryUsage_ += entrySize(*updated);
+            it->second.entry = std::move(updated);
+            evictLocked(shard);
+        }
+        evict();
+    }
+}
+
+bool StaticFileCache::addWatch(const std::string& dir)
+{
+    int wd = ::inotify_add_watch(inotifyFd_, dir.c_str(), kWatchMask);
+    if (wd < 0)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    watches_[wd] = dir;
+    return true;
+}
+
+void StaticFileCache::rewatch(int wd)
+{
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        auto it = watches_.find(wd);
+        if (it == watches_.end())
+        {
+            // 已经处理过（如 IN_DELETE_SELF 之后的 IN_IGNORED）
+            return;
+        }
+        dir = std::move(it->second);
+        watches_.erase(it);
+    }
+    // 目录被移走时 watch 仍然跟着原来的目录，先移除；目录已删除时返回 EINVAL，忽略
+    ::inotify_rm_watch(inotifyFd_, wd);
+    LOG_WARN << "static file directory removed or replaced: " << dir;
+    if (!addWatch(dir))
+    {
+        lostWatches_.push_back(dir);
+    }
+    flushAll();
+}
+
+void StaticFileCache::retryLostWatches()
+{
+    for (auto it = lostWatches_.begin(); it != lostWatches_.end(); )
+    {
+        if (addWatch(*it))
+        {
+            // 没有监视的期间加载的内容可能已经过时
+            LOG_INFO << "static file directory watched again: " << *it;
+            it = lostWatches_.erase(it);
+            flushAll();
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void StaticFileCache::watchLoop()
+{
+    alignas(struct inotify_event) char buf[4096];
+    struct pollfd pfd = { inotifyFd_, POLLIN, 0 };
+    while (running_)
+    {
+        // 定时醒来检查 running_（析构时线程可以退出），并重试还没有恢复监视的目录
+        int ready = ::poll(&pfd, 1, 1000);
+        if (!lostWatches_.empty())
+        {
+            retryLostWatches();
+        }
+        if (ready <= 0)
+        {
+            continue;
+        }
+
+        ssize_t n = ::read(inotifyFd_, buf, sizeof buf);
+        if (n <= 0)
+        {
+            continue;
+        }
+        for (char* p = buf; p < buf + n; )
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // 丢失了事件，不知道哪些文件变化了
+                LOG_WARN << "inotify queue overflow, flush static file cache";
+                flushAll();
+                continue;
+            }
+            if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+            {
+                rewatch(event->wd);
+                continue;
+            }
+            if (event->len == 0)
+            {
+                continue;
+            }
+
+            std::string path;
+            {
+                std::lock_guard<std::mutex> lock(watchMutex_);
+                auto it = watches_.find(event->wd);
+                if (it == watches_.end())
+                {
+                    continue;
+                }
+                path = it->second + "/" + event->name;
+            }
+            LOG_INFO << "static file changed: " << path;
+            invalidate(path);
+        }
+    }
+}
+
+} // namespace http
@@ -0,0 +1,205 @@
+#include "../../include/http/StaticResource.h"
+
+#include <charconv>
+
+#include "../../include/http/FileBody.h"
+#include "../../include/http/HttpDate.h"
+
+namespace http
+{
+
+namespace
+{
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// If-None-Match 使用弱比较：忽略 W/ 前缀
+std::string_view opaqueTag(std::string_view etag)
+{
+    if (etag.size() >= 2 && etag[0] == 'W' && etag[1] == '/')
+    {
+        etag.remove_prefix(2);
+    }
+    return etag;
+}
+
+bool parseSize(std::string_view s, size_t* value)
+{
+    if (s.empty())
+    {
+        return false;
+    }
+    auto result = std::from_chars(s.data(), s.data() + s.size(), *value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+} // namespace
+
+bool StaticResource::notModified(const HttpRequest& req, const Validators& validators)
+{
+    std::string_view ifNoneMatch = req.header("If-None-Match");
+    if (!ifNoneMatch.empty())
+    {
+        std::string_view etag = opaqueTag(validators.etag);
+        while (!ifNoneMatch.empty())
+        {
+            size_t comma = ifNoneMatch.find(',');
+            std::string_view tag = trim(ifNoneMatch.substr(0, comma));
+            if (tag == "*" || opaqueTag(tag) == etag)
+            {
+                return true;
+            }
+            ifNoneMatch = comma == std::string_view::npos ? std::string_view() : ifNoneMatch.substr(comma + 1);
+        }
+        // 有 If-None-Match 时忽略 If-Modified-Since
+        return false;
+    }
+
+    time_t since;
+    std::string_view ifModifiedSince = req.header("If-Modified-Since");
+    return !ifModifiedSince.empty() && HttpDate::parse(ifModifiedSince, &since) && validators.mtime <= since;
+}
+
+StaticResource::RangeStatus StaticResource::parseRange(const HttpRequest& req, const Validators& validators,
+                                                       size_t size, size_t* first, size_t* last)
+{
+    std::string_view range = trim(req.header("Range"));
+    const std::string_view kBytes = "bytes=";
+    if (req.method() != HttpRequest::kGet || range.substr(0, kBytes.size()) != kBytes)
+    {
+        return kFull;
+    }
+    range = trim(range.substr(kBytes.size()));
+    // 多区间需要 multipart/byteranges，直接返回完整内容
+    if (range.find(',') != std::string_view::npos)
+    {
+        return kFull;
+    }
+
+    // If-Range 与当前版本不一致时，资源已经变了，返回完整内容
+    std::string_view ifRange = trim(req.header("If-Range"));
+    if (!ifRange.empty() && ifRange != validators.etag && ifRange != validators.lastModified)
+    {
+        return kFull;
+    }
+
+    size_t dash = range.find('-');
+    if (dash == std::string_view::npos)
+    {
+        return kFull;
+    }
+    std::string_view firstPart = trim(range.substr(0, dash));
+    std::string_view lastPart = trim(range.substr(dash + 1));
+
+    if (firstPart.empty())
+    {
+        // 后缀区间：最后 n 个字节
+        size_t suffix;
+        if (!parseSize(lastPart, &suffix))
+        {
+            return kFull;
+        }
+        if (suffix == 0 || size == 0)
+        {
+            return kUnsatisfiable;
+        }
+        *first = suffix >= size ? 0 : size - suffix;
+        *last = size - 1;
+        return kPartial;
+    }
+
+    if (!parseSize(firstPart, first))
+    {
+        return kFull;
+    }
+    if (lastPart.empty())
+    {
+        *last = size - 1;
+    }
+    else if (!parseSize(lastPart, last) || *last < *first)
+    {
+        return kFull;
+    }
+    if (*first >= size)
+    {
+        return kUnsatisfiable;
+    }
+    if (*last >= size)
+    {
+        *last = size - 1;
+    }
+    return kPartial;
+}
+
+bool StaticResource::prepare(const HttpRequest& req, const Validators& validators, size_t size,
+                             HttpResponse* resp, RangeStatus* status, size_t* first, size_t* last)
+{
+    resp->addHeader("ETag", std::string(validators.etag));
+    resp->addHeader("Last-Modified", std::string(validators.lastModified));
+
+    if (notModified(req, validators))
+    {
+        resp->setStatusCode(HttpResponse::k304NotModified);
+        resp->setStatusMessage("Not Modified");
+        resp->setBody(std::string());
+        return false;
+    }
+
+    resp->addHeader("Accept-Ranges", "bytes");
+    *status = parseRange(req, validators, size, first, last);
+    if (*status == kPartial)
+    {
+        resp->setStatusCode(HttpResponse::k206PartialContent);
+        resp->setStatusMessage("Partial Content");
+        resp->addHeader("Content-Range", "bytes " + std::to_string(*first) + "-" +
+                                         std::to_string(*last) + "/" + std::to_string(size));
+    }
+    else if (*status == kUnsatisfiable)
+    {
+        resp->setStatusCode(HttpResponse::k416RangeNotSatisfiable);
+        resp->setStatusMessage("Range Not Satisfiable");
+        resp->addHeader("Content-Range", "bytes */" + std::to_string(size));
+        resp->setBody(std::string());
+    }
+    return true;
+}
+
+bool StaticResource::serveFile(const HttpRequest& req, const std::string& path, HttpResponse* resp)
+{
+    // 只 open + fstat，304 时不读取内容
+    std::shared_ptr<const FileBody> file = FileBody::open(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string lastModified = HttpDate::format(file->lastModified());
+    Validators validators{ file->etag(), file->lastModified(), lastModified };
+    RangeStatus status = kFull;
+    size_t first = 0;
+    size_t last = 0;
+    if (!prepare(req, validators, file->size(), resp, &status, &first, &last) || status == kUnsatisfiable)
+    {
+        return true;
+    }
+
+    resp->setFile(std::move(file));
+    if (status == kPartial)
+    {
+        resp->setFileRange(first, last - first + 1);
+    }
+    return true;
+}
+
+} // namespace http
@@ -6,29 +6,60 @@ namespace http
 namespace middleware
 {
 
+bool MiddlewareChain::Entry::matches(std::string_view path) const
+{
+    if (prefix.empty())
+    {
+        return true;
+    }
+    // 按路径段匹配：/api 不匹配 /apix
+    return path.substr(0, prefix.size()) == prefix &&
+           (path.size() == prefix.size() || prefix.back() == '/' || path[prefix.size()] == '/');
+}
+
 void MiddlewareChain::addMiddleware(std::shared_ptr<Middleware> middleware)
 {
-    middlewares_.push_back(middleware);
+    addMiddleware(std::string(), std::move(middleware));
+}
+
+void MiddlewareChain::addMiddleware(const std::string &prefix, std::shared_ptr<Middleware> middleware)
+{
+    if (!middleware)
+    {
+        LOG_ERROR << "Ignore null middleware for prefix " << prefix;
+        return;
+    }
+    middlewares_.push_back(Entry{ prefix, std::move(middleware) });
 }
 
-void MiddlewareChain::processBefore(HttpRequest &request)
+bool MiddlewareChain::processBefore(HttpRequest &request, HttpResponse &response, size_t *depth)
 {
-    for (auto &middleware : middlewares_)
+    for (size_t i = 0; i < middlewares_.size(); ++i)
     {
-        middleware->before(request);
+        const Entry &entry = middlewares_[i];
+        if (entry.matches(request.pathView()) &&
+            entry.middleware->before(request, response) == Middleware::kRespond)
+        {
+            // 生成响应的中间件本身不再调用 after
+            *depth = i;
+            return false;
+        }
     }
+    *depth = middlewares_.size();
+    return true;
 }
 
-void MiddlewareChain::processAfter(HttpResponse &response)
+void MiddlewareChain::processAfter(const HttpRequest &request, HttpResponse &response, size_t depth)
 {
     try
     {
         // 反向处理响应，以保持中间件的正确执行顺序
-        for (auto it = middlewares_.rbegin(); it != middlewares_.rend(); ++it)
+        for (size_t i = depth; i > 0; --i)
         {
-            if (*it)
-            { // 添加空指针检查
-                (*it)->after(response);
+            const Entry &entry = middlewares_[i - 1];
+            if (entry.matches(request.pathView()))
+            {
+                entry.middleware->after(request, response);
             }
         }
     }
@@ -0,0 +1,55 @@
+#include "../../../include/middleware/auth/AuthMiddleware.h"
+#include "../../../include/router/Router.h"
+
+#include <charconv>
+
+namespace http
+{
+namespace middleware
+{
+
+AuthMiddleware::AuthMiddleware(session::SessionManager* sessionManager, const AuthConfig& config)
+    : sessionManager_(sessionManager)
+    , config_(config)
+{
+}
+
+Middleware::Result AuthMiddleware::before(HttpRequest& request, HttpResponse& response)
+{
+    AuthContext auth;
+    if (!request.cookie(session::SessionManager::kCookieName).empty())
+    {
+        auth = resolve(*sessionManager_->getSession(request, &response));
+    }
+    request.setAuth(auth);
+
+    if (config_.required && !auth.loggedIn)
+    {
+        router::Router::respondUnauthorized(request, &response);
+        return kRespond;
+    }
+    return kContinue;
+}
+
+AuthContext AuthMiddleware::resolve(const session::Session& session) const
+{
+    AuthContext auth;
+    if (session.getValue(config_.loggedInKey) != "true")
+    {
+        return auth;
+    }
+    std::string userId = session.getValue(config_.userIdKey);
+    int id = 0;
+    auto result = std::from_chars(userId.data(), userId.data() + userId.size(), id);
+    if (userId.empty() || result.ec != std::errc() || result.ptr != userId.data() + userId.size())
+    {
+        return auth;
+    }
+    auth.userId = id;
+    auth.loggedIn = true;
+    auth.role = session.getValue(config_.roleKey) == "admin" ? AuthContext::kAdmin : AuthContext::kUser;
+    return auth;
+}
+
+} // namespace middleware
+} // namespace http
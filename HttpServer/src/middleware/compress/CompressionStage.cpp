@@ -0,0 +1,184 @@
+#include "../../../include/middleware/compress/CompressionStage.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <muduo/base/Logging.h>
+
+#include "../../../include/utils/CompressUtil.h"
+
+namespace http 
+{
+namespace middleware 
+{
+
+namespace
+{
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// "gzip;q=0.8" -> 编码名和 q 值，没有 q 参数时为 1
+std::string_view parseCoding(std::string_view item, double* q)
+{
+    *q = 1.0;
+    size_t semicolon = item.find(';');
+    std::string_view coding = trim(item.substr(0, semicolon));
+    while (semicolon != std::string_view::npos)
+    {
+        item.remove_prefix(semicolon + 1);
+        semicolon = item.find(';');
+        std::string_view param = trim(item.substr(0, semicolon));
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+        {
+            *q = std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+        }
+    }
+    return coding;
+}
+
+} // namespace
+
+CompressionStage::CompressionStage(const CompressionConfig& config) : config_(config) {}
+
+CompressionStage::Preference CompressionStage::negotiate(std::string_view acceptEncoding) const
+{
+    double brQ = -1;
+    double gzipQ = -1;
+    double anyQ = -1;
+    while (!acceptEncoding.empty())
+    {
+        size_t comma = acceptEncoding.find(',');
+        double q;
+        std::string_view coding = parseCoding(acceptEncoding.substr(0, comma), &q);
+        if (iequals(coding, "br"))
+        {
+            brQ = q;
+        }
+        else if (iequals(coding, "gzip") || iequals(coding, "x-gzip"))
+        {
+            gzipQ = q;
+        }
+        else if (coding == "*")
+        {
+            anyQ = q;
+        }
+        acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+    }
+
+    // 没有单独列出的编码按 "*" 处理
+    if (brQ < 0)
+    {
+        brQ = anyQ;
+    }
+    if (gzipQ < 0)
+    {
+        gzipQ = anyQ;
+    }
+    if (!config_.enableBrotli)
+    {
+        brQ = -1;
+    }
+
+    // q 值相同时优先 br（压缩率更高）
+    Preference preference;
+    if (brQ > 0 && brQ >= gzipQ)
+    {
+        preference.encodings[preference.count++] = kBrotli;
+    }
+    if (gzipQ > 0)
+    {
+        preference.encodings[preference.count++] = kGzip;
+    }
+    if (brQ > 0 && brQ < gzipQ)
+    {
+        preference.encodings[preference.count++] = kBrotli;
+    }
+    return preference;
+}
+
+void CompressionStage::process(const HttpRequest& request, HttpResponse& response) const
+{
+    HttpResponse::HttpStatusCode status = response.getStatusCode();
+    if ((status != HttpResponse::k200Ok && status != HttpResponse::k304NotModified) ||
+        !response.getHeader("Content-Encoding").empty() ||
+        !CompressUtil::compressible(response.getHeader("Content-Type")))
+    {
+        return;
+    }
+    // 同一个 URL 的内容随 Accept-Encoding 变化，缓存需要区分
+    response.addVary("Accept-Encoding");
+
+    size_t size = response.bodySize();
+    if (status != HttpResponse::k200Ok || size < config_.minSize)
+    {
+        return;
+    }
+    Preference preference = negotiate(request.header("Accept-Encoding"));
+    if (preference.count == 0)
+    {
+        return;
+    }
+
+    // 有预压缩版本时按候选顺序选用第一个存在的版本
+    Encoding encoding = preference.encodings[0];
+    std::shared_ptr<const std::string> compressed;
+    for (size_t i = 0; i < preference.count && !compressed; ++i)
+    {
+        encoding = preference.encodings[i];
+        compressed = encoding == kBrotli ? response.brotliBody() : response.gzipBody();
+    }
+    if (!compressed)
+    {
+        // 文件响应体分块发送，不读进内存压缩；预压缩时判断为不值得压缩的、关闭了现场压缩的也不再尝试
+        if (response.isFile() || !response.liveCompression() || response.gzipBody() || response.brotliBody())
+        {
+            return;
+        }
+        encoding = preference.encodings[0];
+
+        std::string joined;
+        std::string_view input = response.body();
+        if (response.isSegmented())
+        {
+            joined.reserve(size);
+            for (std::string_view segment : response.segments())
+            {
+                joined.append(segment.data(), segment.size());
+            }
+            input = joined;
+        }
+
+        auto output = std::make_shared<std::string>();
+        bool ok = encoding == kBrotli ? CompressUtil::brotli(input, config_.brotliQuality, output.get())
+                                      : CompressUtil::gzip(input, config_.gzipLevel, output.get());
+        if (!ok || output->size() >= size)
+        {
+            return;
+        }
+        compressed = std::move(output);
+    }
+
+    // 编码后的表示与原内容字节不同，强 ETag 不再成立
+    std::string_view etag = response.getHeader("ETag");
+    if (!etag.empty() && etag.substr(0, 2) != "W/")
+    {
+        response.addHeader("ETag", "W/" + std::string(etag));
+    }
+    response.addHeader("Content-Encoding", encoding == kBrotli ? "br" : "gzip");
+    response.setContentLength(compressed->size());
+    response.setBody(std::move(compressed));
+}
+
+} // namespace middleware
+} // namespace http
@@ -1,7 +1,6 @@
 #include "../../../include/middleware/cors/CorsMiddleware.h"
 #include <algorithm>
 #include <sstream>
-#include <iostream>
 #include <muduo/base/Logging.h>
 
 namespace http 
@@ -9,101 +8,140 @@ namespace http
 namespace middleware 
 {
 
-CorsMiddleware::CorsMiddleware(const CorsConfig& config) : config_(config) {}
+CorsMiddleware::CorsMiddleware(const CorsConfig& config)
+    : config_(config)
+    // 没有配置允许的源时与 "*" 相同，允许任意源
+    , anyOrigin_(config.allowedOrigins.empty() ||
+                 std::find(config.allowedOrigins.begin(), config.allowedOrigins.end(), "*")
+                 != config.allowedOrigins.end())
+    , varyOrigin_(!anyOrigin_)
+    , wildcardHeaders_("Access-Control-Allow-Origin: *\r\n")
+{
+    // 允许任意源又允许凭据时，任何网站都能带着用户的 Cookie 读取响应，必须显式列出信任的源
+    if (config_.allowCredentials && anyOrigin_)
+    {
+        LOG_FATAL << "CORS allowCredentials requires an explicit allowedOrigins list, not empty or \"*\"";
+    }
+    if (config_.allowCredentials) 
+    {
+        credentialsHeader_ = "Access-Control-Allow-Credentials: true\r\n";
+    }
 
-void CorsMiddleware::before(HttpRequest& request) 
+    for (const std::string& origin : config_.allowedOrigins)
+    {
+        if (origin == "*")
+        {
+            continue;
+        }
+        size_t star = origin.find('*');
+        if (star == std::string::npos)
+        {
+            originHeaders_.emplace(origin, "Access-Control-Allow-Origin: " + origin + "\r\n" + credentialsHeader_);
+        }
+        else if (origin.find('*', star + 1) == std::string::npos)
+        {
+            patterns_.push_back(OriginPattern{ origin.substr(0, star), origin.substr(star + 1) });
+        }
+        else
+        {
+            LOG_WARN << "Ignore CORS origin pattern with more than one '*': " << origin;
+        }
+    }
+
+    if (!config_.allowedMethods.empty()) 
+    {
+        preflightHeaders_ += "Access-Control-Allow-Methods: " + join(config_.allowedMethods, ", ") + "\r\n";
+    }
+    if (!config_.allowedHeaders.empty()) 
+    {
+        preflightHeaders_ += "Access-Control-Allow-Headers: " + join(config_.allowedHeaders, ", ") + "\r\n";
+    }
+    preflightHeaders_ += "Access-Control-Max-Age: " + std::to_string(config_.maxAge) + "\r\n";
+}
+
+CorsMiddleware::Result CorsMiddleware::before(HttpRequest& request, HttpResponse& response) 
 {
-    LOG_DEBUG << "CorsMiddleware::before - Processing request";
-    
     if (request.method() == HttpRequest::Method::kOptions) 
     {
-        LOG_INFO << "Processing CORS preflight request";
-        HttpResponse response;
         handlePreflightRequest(request, response);
-        throw response;
+        return kRespond;
     }
+    return kContinue;
+}
+
+void CorsMiddleware::after(const HttpRequest& request, HttpResponse& response) 
+{
+    addCorsHeaders(request.header(HeaderId::kOrigin), response);
 }
 
-void CorsMiddleware::after(HttpResponse& response) 
+bool CorsMiddleware::matchesPattern(std::string_view origin) const
 {
-    LOG_DEBUG << "CorsMiddleware::after - Processing response";
-    
-    // 直接添加CORS头，简化处理逻辑
-    if (!config_.allowedOrigins.empty()) 
+    for (const OriginPattern& pattern : patterns_)
     {
-        // 如果允许所有源
-        if (std::find(config_.allowedOrigins.begin(), config_.allowedOrigins.end(), "*") 
-            != config_.allowedOrigins.end()) 
+        // 通配部分不能为空，也不能跨越路径或端口（'/'、':'）
+        if (origin.size() > pattern.prefix.size() + pattern.suffix.size() &&
+            origin.substr(0, pattern.prefix.size()) == pattern.prefix &&
+            origin.substr(origin.size() - pattern.suffix.size()) == pattern.suffix)
         {
-            addCorsHeaders(response, "*");
-        } 
-        else 
-        {
-            // 添加第一个允许的源
-            addCorsHeaders(response, config_.allowedOrigins[0]);
+            std::string_view middle = origin.substr(pattern.prefix.size(),
+                                                    origin.size() - pattern.prefix.size() - pattern.suffix.size());
+            if (middle.find_first_of("/:") == std::string_view::npos)
+            {
+                return true;
+            }
         }
     }
+    return false;
 }
 
-bool CorsMiddleware::isOriginAllowed(const std::string& origin) const 
+bool CorsMiddleware::addCorsHeaders(std::string_view origin, HttpResponse& response) const
 {
-    return config_.allowedOrigins.empty() || 
-           std::find(config_.allowedOrigins.begin(), 
-                    config_.allowedOrigins.end(), "*") != config_.allowedOrigins.end() ||
-           std::find(config_.allowedOrigins.begin(), 
-                    config_.allowedOrigins.end(), origin) != config_.allowedOrigins.end();
+    if (!varyOrigin_)
+    {
+        response.appendRawHeaders(wildcardHeaders_);
+        return true;
+    }
+
+    // 响应随 Origin 变化（不论这次是否匹配），下游缓存需要按 Origin 区分
+    response.addVary("Origin");
+    if (origin.empty())
+    {
+        return false;
+    }
+
+    auto it = originHeaders_.find(origin);
+    if (it != originHeaders_.end())
+    {
+        response.appendRawHeaders(it->second);
+        return true;
+    }
+    if (!matchesPattern(origin))
+    {
+        return false;
+    }
+    response.addHeader("Access-Control-Allow-Origin", std::string(origin));
+    if (!credentialsHeader_.empty())
+    {
+        response.appendRawHeaders(credentialsHeader_);
+    }
+    return true;
 }
 
 void CorsMiddleware::handlePreflightRequest(const HttpRequest& request, 
-                                          HttpResponse& response) 
+                                            HttpResponse& response) const
 {
-    const std::string& origin = request.getHeader("Origin");
-    
-    if (!isOriginAllowed(origin)) 
+    std::string_view origin = request.header(HeaderId::kOrigin);
+    if (!addCorsHeaders(origin, response)) 
     {
-        LOG_WARN << "Origin not allowed: " << origin;
+        LOG_WARN << "Origin not allowed: " << std::string(origin);
         response.setStatusCode(HttpResponse::k403Forbidden);
+        response.setStatusMessage("Forbidden");
         return;
     }
 
-    addCorsHeaders(response, origin);
+    response.appendRawHeaders(preflightHeaders_);
     response.setStatusCode(HttpResponse::k204NoContent);
-    LOG_INFO << "Preflight request processed successfully";
-}
-
-void CorsMiddleware::addCorsHeaders(HttpResponse& response, 
-                                  const std::string& origin) 
-{
-    try 
-    {
-        response.addHeader("Access-Control-Allow-Origin", origin);
-        
-        if (config_.allowCredentials) 
-        {
-            response.addHeader("Access-Control-Allow-Credentials", "true");
-        }
-        
-        if (!config_.allowedMethods.empty()) 
-        {
-            response.addHeader("Access-Control-Allow-Methods", 
-                             join(config_.allowedMethods, ", "));
-        }
-        
-        if (!config_.allowedHeaders.empty()) 
-        {
-            response.addHeader("Access-Control-Allow-Headers", 
-                             join(config_.allowedHeaders, ", "));
-        }
-        
-        response.addHeader("Access-Control-Max-Age", 
-                          std::to_string(config_.maxAge));
-        
-        LOG_DEBUG << "CORS headers added successfully";
-    } 
-    catch (const std::exception& e) 
-    {
-        LOG_ERROR << "Error adding CORS headers: " << e.what();
-    }
+    response.setStatusMessage("No Content");
 }
 
 // 工具函数：将字符串数组连接成单个字符串
@@ -119,4 +157,4 @@ std::string CorsMiddleware::join(const std::vector<std::string>& strings, const
 }
 
 } // namespace middleware
-} // namespace http
\ No newline at end of file
+} // namespace http
@@ -0,0 +1,208 @@
+#include "../../include/router/RadixTree.h"
+
+#include <algorithm>
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+namespace router
+{
+
+struct RadixTree::Node
+{
+    std::string                        prefix; // 静态节点的前缀（已与兄弟节点压缩）
+    std::string                        indices; // staticChildren 各自前缀的首字符，顺序一致
+    std::vector<std::unique_ptr<Node>> staticChildren;
+    std::unique_ptr<Node>              paramChild; // :name
+    std::unique_ptr<Node>              wildcardChild; // *name
+    std::string                        paramName; // 参数 / 通配节点的名字
+    int                                value { kNoValue };
+    int                                priority { 0 }; // 子树中的路由数
+};
+
+RadixTree::RadixTree()
+    : root_(std::make_unique<Node>())
+{
+}
+
+RadixTree::~RadixTree() = default;
+
+RadixTree::Node* RadixTree::insertStatic(Node* node, std::string_view segment, std::vector<Node*>* visited)
+{
+    while (!segment.empty())
+    {
+        size_t i = node->indices.find(segment[0]);
+        if (i == std::string::npos)
+        {
+            auto child = std::make_unique<Node>();
+            child->prefix = std::string(segment);
+            node->indices.push_back(segment[0]);
+            node->staticChildren.push_back(std::move(child));
+            visited->push_back(node->staticChildren.back().get());
+            return node->staticChildren.back().get();
+        }
+
+        Node* child = node->staticChildren[i].get();
+        size_t common = 0;
+        size_t limit = std::min(child->prefix.size(), segment.size());
+        while (common < limit && child->prefix[common] == segment[common])
+        {
+            ++common;
+        }
+
+        if (common < child->prefix.size())
+        {
+            // 拆分：公共部分成为新的中间节点，原节点挂在它下面
+            auto middle = std::make_unique<Node>();
+            middle->prefix = child->prefix.substr(0, common);
+            middle->priority = child->priority;
+            child->prefix.erase(0, common);
+            middle->indices.push_back(child->prefix[0]);
+            middle->staticChildren.push_back(std::move(node->staticChildren[i]));
+            node->staticChildren[i] = std::move(middle);
+            child = node->staticChildren[i].get();
+        }
+        node = child;
+        visited->push_back(node);
+        segment.remove_prefix(common);
+    }
+    return node;
+}
+
+void RadixTree::sortChildren(Node* node)
+{
+    std::stable_sort(node->staticChildren.begin(), node->staticChildren.end(),
+                     [](const std::unique_ptr<Node>& a, const std::unique_ptr<Node>& b) {
+                         return a->priority > b->priority;
+                     });
+    node->indices.clear();
+    for (const auto& child : node->staticChildren)
+    {
+        node->indices.push_back(child->prefix[0]);
+    }
+}
+
+int* RadixTree::insert(std::string_view pattern)
+{
+    std::vector<Node*> visited;
+    Node* node = root_.get();
+    visited.push_back(node);
+
+    while (!pattern.empty())
+    {
+        size_t special = pattern.find_first_of(":*");
+        if (special != 0)
+        {
+            node = insertStatic(node, pattern.substr(0, special), &visited);
+            if (special == std::string_view::npos)
+            {
+                break;
+            }
+            pattern.remove_prefix(special);
+            continue;
+        }
+
+        bool wildcard = pattern[0] == '*';
+        size_t end = wildcard ? pattern.size() : pattern.find('/');
+        std::string_view name = pattern.substr(1, end == std::string_view::npos ? std::string_view::npos : end - 1);
+        if (!wildcard && name.empty())
+        {
+            LOG_ERROR << "route parameter without a name: " << pattern;
+            return nullptr;
+        }
+
+        std::unique_ptr<Node>& slot = wildcard ? node->wildcardChild : node->paramChild;
+        std::string nameStr = wildcard && name.empty() ? std::string("*") : std::string(name);
+        if (!slot)
+        {
+            slot = std::make_unique<Node>();
+            slot->paramName = nameStr;
+        }
+        else if (slot->paramName != nameStr)
+        {
+            LOG_ERROR << "conflicting route parameter names: " << slot->paramName << " / " << nameStr;
+            return nullptr;
+        }
+        node = slot.get();
+        visited.push_back(node);
+        pattern = end == std::string_view::npos ? std::string_view() : pattern.substr(end);
+    }
+
+    if (node->value == kNoValue)
+    {
+        // 新路由：沿途节点的优先级加一，重新排列静态子节点
+        for (Node* n : visited)
+        {
+            ++n->priority;
+        }
+        for (Node* n : visited)
+        {
+            sortChildren(n);
+        }
+    }
+    return &node->value;
+}
+
+bool RadixTree::match(const Node* node, std::string_view path, PathParams* params, int* value)
+{
+    if (path.empty() && node->value != kNoValue)
+    {
+        *value = node->value;
+        return true;
+    }
+
+    // 1. 静态子节点：首字符相同的最多一个
+    if (!path.empty())
+    {
+        size_t i = node->indices.find(path[0]);
+        if (i != std::string::npos)
+        {
+            const Node* child = node->staticChildren[i].get();
+            if (path.size() >= child->prefix.size() &&
+                path.compare(0, child->prefix.size(), child->prefix) == 0 &&
+                match(child, path.substr(child->prefix.size()), params, value))
+            {
+                return true;
+            }
+        }
+    }
+
+    // 2. 参数：匹配一个非空路径段
+    if (node->paramChild && !path.empty())
+    {
+        size_t end = std::min(path.find('/'), path.size());
+        if (end > 0 && params->push(node->paramChild->paramName, path.substr(0, end)))
+        {
+            if (match(node->paramChild.get(), path.substr(end), params, value))
+            {
+                return true;
+            }
+            params->pop();
+        }
+    }
+
+    // 3. 通配：剩下的全部路径
+    if (node->wildcardChild && node->wildcardChild->value != kNoValue &&
+        params->push(node->wildcardChild->paramName, path))
+    {
+        *value = node->wildcardChild->value;
+        return true;
+    }
+    return false;
+}
+
+int RadixTree::match(std::string_view path, PathParams* params) const
+{
+    int value = kNoValue;
+    size_t count = params->size();
+    if (!match(root_.get(), path, params, &value))
+    {
+        params->truncate(count);
+        return kNoValue;
+    }
+    return value;
+}
+
+} // namespace router
+} // namespace http
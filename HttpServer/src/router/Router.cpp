@@ -6,74 +6,159 @@ namespace http
 namespace router
 {
 
+Router::Route *Router::addRoute(HttpRequest::Method method, const std::string &pattern)
+{
+    int *slot = trees_[method].insert(pattern);
+    if (slot == nullptr)
+    {
+        LOG_ERROR << "invalid route pattern: " << pattern;
+        return nullptr;
+    }
+    if (*slot == RadixTree::kNoValue)
+    {
+        *slot = static_cast<int>(routes_.size());
+        routes_.push_back(std::make_unique<Route>());
+        routes_.back()->pattern = pattern;
+    }
+    return routes_[*slot].get();
+}
+
 void Router::registerHandler(HttpRequest::Method method, const std::string &path, HandlerPtr handler)
 {
-    RouteKey key{method, path};
-    handlers_[key] = std::move(handler);
+    if (Route *route = addRoute(method, path))
+    {
+        route->handler = std::move(handler);
+    }
 }
 
 void Router::registerCallback(HttpRequest::Method method, const std::string &path, const HandlerCallback &callback)
 {
-    RouteKey key{method, path};
-    callbacks_[key] = std::move(callback);
+    if (Route *route = addRoute(method, path))
+    {
+        route->callback = callback;
+    }
+}
+
+void Router::registerAsyncCallback(HttpRequest::Method method, const std::string &path, const AsyncCallback &callback)
+{
+    if (Route *route = addRoute(method, path))
+    {
+        route->asyncCallback = callback;
+    }
+}
+
+void Router::setCacheControl(HttpRequest::Method method, const std::string &path, const std::string &value)
+{
+    if (Route *route = addRoute(method, path))
+    {
+        route->cacheControl = value;
+    }
 }
 
-bool Router::route(const HttpRequest &req, HttpResponse *resp)
+void Router::setBlocking(HttpRequest::Method method, const std::string &path)
 {
-    RouteKey key{req.method(), req.path()};
+    if (Route *route = addRoute(method, path))
+    {
+        route->blocking = true;
+    }
+}
 
-    // 查找处理器
-    auto handlerIt = handlers_.find(key);
-    if (handlerIt != handlers_.end())
+void Router::setAuthRequired(HttpRequest::Method method, const std::string &path)
+{
+    if (Route *route = addRoute(method, path))
     {
-        handlerIt->second->handle(req, resp);
-        return true;
+        route->authRequired = true;
     }
+}
 
-    // 查找回调函数
-    auto callbackIt = callbacks_.find(key);
-    if (callbackIt != callbacks_.end())
+const Router::Route *Router::find(HttpRequest::Method method, std::string_view path, PathParams *params) const
+{
+    if (method >= static_cast<int>(kMethodCount))
     {
-        callbackIt->second(req, resp);
-        return true;
+        return nullptr;
+    }
+    int index = trees_[method].match(path, params);
+    if (index == RadixTree::kNoValue || !routes_[index]->hasHandler())
+    {
+        return nullptr;
     }
+    return routes_[index].get();
+}
+
+const Router::Route *Router::match(HttpRequest &req) const
+{
+    req.pathParams().clear();
+    return find(req.method(), req.pathView(), &req.pathParams());
+}
 
-    // 查找动态路由处理器
-    for (const auto &[method, pathRegex, handler] : regexHandlers_)
+bool Router::route(HttpRequest &req, HttpResponse *resp)
+{
+    const Route *route = match(req);
+    if (route == nullptr)
     {
-        std::smatch match;
-        std::string pathStr(req.path());
-        // 如果方法匹配并且动态路由匹配，则执行处理器
-        if (method == req.method() && std::regex_match(pathStr, match, pathRegex))
-        {
-            // Extract path parameters and add them to the request
-            HttpRequest newReq(req); // 因为这里需要用这一次所以是可以改的
-            extractPathParameters(match, newReq);
-            
-            handler->handle(newReq, resp);
-            return true;
-        }
+        return false;
+    }
+    if (!authorize(*route, req, resp))
+    {
+        return true;
     }
 
-    // 查找动态路由回调函数
-    for (const auto &[method, pathRegex, callback] : regexCallbacks_)
+    if (route->handler)
+    {
+        dispatch(route->handler, req, resp);
+    }
+    else if (route->callback)
     {
-        std::smatch match;
-        std::string pathStr(req.path());
-        // 如果方法匹配并且动态路由匹配，则执行回调函数
-        if (method == req.method() && std::regex_match(pathStr, match, pathRegex))
-        {
-             // Extract path parameters and add them to the request
-            HttpRequest newReq(req); // 因为这里需要用这一次所以是可以改的
-            extractPathParameters(match, newReq);
+        route->callback(req, resp);
+    }
+    else
+    {
+        // 协程式处理器只能由 HttpServer 驱动
+        return false;
+    }
+    applyCacheControl(*route, resp);
+    return true;
+}
 
-            callback(req, resp);
-            return true;
-        }
+void Router::applyCacheControl(std::string_view cacheControl, HttpResponse *resp)
+{
+    if (cacheControl.empty())
+    {
+        return;
+    }
+    HttpResponse::HttpStatusCode code = resp->getStatusCode();
+    if (code != HttpResponse::k200Ok && code != HttpResponse::k206PartialContent &&
+        code != HttpResponse::k304NotModified)
+    {
+        return;
     }
+    if (resp->getHeader("Cache-Control").empty())
+    {
+        resp->addHeader("Cache-Control", std::string(cacheControl));
+    }
+}
 
-    return false;
+void Router::respondUnauthorized(const HttpRequest &req, HttpResponse *resp)
+{
+    static const auto body = std::make_shared<const std::string>(
+        "{\"status\":\"error\",\"message\":\"Unauthorized\"}");
+    resp->setStatusLine(req.getVersion(), HttpResponse::k401Unauthorized, "Unauthorized");
+    resp->setContentType("application/json");
+    resp->setBody(body);
+}
+
+void Router::dispatch(const HandlerPtr &handler, const HttpRequest &req, HttpResponse *resp)
+{
+    // 请求体已经以流式方式交付给处理器，由 onBodyEnd 生成响应
+    if (req.bodyStreamed())
+    {
+        handler->onBodyEnd(req, resp);
+    }
+    else
+    {
+        handler->handle(req, resp);
+    }
 }
 
 } // namespace router
-} // namespace http
\ No newline at end of file
+} // namespace http
@@ -0,0 +1,348 @@
+#include "../../include/session/CookieSessionStorage.h"
+
+#include <chrono>
+#include <charconv>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+namespace session
+{
+
+namespace
+{
+
+const size_t kNonceLength = 12;
+const size_t kTagLength = 16;
+// 浏览器对单个 Cookie 的限制约为 4KB
+const size_t kMaxCookieLength = 4000;
+
+const char kBase64Url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+std::string base64UrlEncode(std::string_view data)
+{
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3)
+    {
+        uint32_t n = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8) |
+                     static_cast<uint8_t>(data[i + 2]);
+        out += kBase64Url[(n >> 18) & 63];
+        out += kBase64Url[(n >> 12) & 63];
+        out += kBase64Url[(n >> 6) & 63];
+        out += kBase64Url[n & 63];
+    }
+    if (i < data.size())
+    {
+        uint32_t n = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size())
+        {
+            n |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        out += kBase64Url[(n >> 18) & 63];
+        out += kBase64Url[(n >> 12) & 63];
+        if (i + 1 < data.size())
+        {
+            out += kBase64Url[(n >> 6) & 63];
+        }
+    }
+    return out;
+}
+
+int base64UrlValue(char c)
+{
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+bool base64UrlDecode(std::string_view data, std::string* out)
+{
+    if (data.size() % 4 == 1)
+    {
+        return false;
+    }
+    out->clear();
+    out->reserve(data.size() / 4 * 3 + 2);
+    uint32_t n = 0;
+    int bits = 0;
+    for (char c : data)
+    {
+        int value = base64UrlValue(c);
+        if (value < 0)
+        {
+            return false;
+        }
+        n = (n << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            *out += static_cast<char>((n >> bits) & 0xFF);
+        }
+    }
+    return true;
+}
+
+std::string hmacSha256(std::string_view key, std::string_view data)
+{
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(), mac, &length);
+    return std::string(reinterpret_cast<const char*>(mac), length);
+}
+
+// 会话编码为 "<过期时间（秒）>\n<id>\n" 之后是 Session::encodeValues 的结果
+std::string encodeSession(const Session& session, int64_t expiry)
+{
+    std::string out = std::to_string(expiry);
+    out += '\n';
+    out += session.getId();
+    out += '\n';
+    session.encodeValues(&out);
+    return out;
+}
+
+bool readNumber(std::string_view* data, char delimiter, uint64_t* value)
+{
+    size_t end = data->find(delimiter);
+    if (end == std::string_view::npos || end == 0)
+    {
+        return false;
+    }
+    auto result = std::from_chars(data->data(), data->data() + end, *value);
+    if (result.ec != std::errc() || result.ptr != data->data() + end)
+    {
+        return false;
+    }
+    data->remove_prefix(end + 1);
+    return true;
+}
+
+} // namespace
+
+CookieSessionStorage::CookieSessionStorage(const std::vector<Key>& keys, bool encrypt)
+    : encrypt_(encrypt)
+{
+    for (const Key& key : keys)
+    {
+        if (key.id.empty() || key.id.find('.') != std::string::npos)
+        {
+            LOG_ERROR << "Invalid session key id: " << key.id;
+            continue;
+        }
+        if (key.secret.size() < 32)
+        {
+            LOG_WARN << "Session key " << key.id << " is shorter than 32 bytes";
+        }
+        keys_.push_back(DerivedKey{ key.id, hmacSha256(key.secret, "session-sign"),
+                                    hmacSha256(key.secret, "session-encrypt") });
+    }
+    if (keys_.empty())
+    {
+        LOG_FATAL << "CookieSessionStorage requires at least one valid key";
+    }
+}
+
+const CookieSessionStorage::DerivedKey* CookieSessionStorage::findKey(std::string_view id) const
+{
+    // 同时有效的密钥只有两三个，线性查找即可
+    for (const DerivedKey& key : keys_)
+    {
+        if (key.id == id)
+        {
+            return &key;
+        }
+    }
+    return nullptr;
+}
+
+std::string CookieSessionStorage::sign(const DerivedKey& key, std::string_view data)
+{
+    return hmacSha256(key.signKey, data);
+}
+
+// 输出 nonce | 密文 | tag
+bool CookieSessionStorage::encrypt(const DerivedKey& key, const std::string& plain, std::string* out)
+{
+    out->assign(kNonceLength + plain.size() + kTagLength, '\0');
+    auto* nonce = reinterpret_cast<unsigned char*>(&(*out)[0]);
+    auto* cipher = nonce + kNonceLength;
+    if (RAND_bytes(nonce, kNonceLength) != 1)
+    {
+        return false;
+    }
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int length = 0;
+    bool ok = ctx != nullptr &&
+              EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr,
+                                 reinterpret_cast<const unsigned char*>(key.encryptKey.data()), nonce) == 1 &&
+              EVP_EncryptUpdate(ctx, cipher, &length,
+                                reinterpret_cast<const unsigned char*>(plain.data()),
+                                static_cast<int>(plain.size())) == 1 &&
+              EVP_EncryptFinal_ex(ctx, cipher + length, &length) == 1 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, kTagLength, cipher + plain.size()) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+}
+
+bool CookieSessionStorage::decrypt(const DerivedKey& key, std::string_view sealed, std::string* out)
+{
+    if (sealed.size() < kNonceLength + kTagLength)
+    {
+        return false;
+    }
+    auto* nonce = reinterpret_cast<const unsigned char*>(sealed.data());
+    auto* cipher = nonce + kNonceLength;
+    size_t cipherLength = sealed.size() - kNonceLength - kTagLength;
+    out->assign(cipherLength, '\0');
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int length = 0;
+    bool ok = ctx != nullptr &&
+              EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr,
+                                 reinterpret_cast<const unsigned char*>(key.encryptKey.data()), nonce) == 1 &&
+              EVP_DecryptUpdate(ctx, reinterpret_cast<unsigned char*>(&(*out)[0]), &length,
+                                cipher, static_cast<int>(cipherLength)) == 1 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, kTagLength,
+                                  const_cast<unsigned char*>(cipher + cipherLength)) == 1 &&
+              EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(&(*out)[0]) + length, &length) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+}
+
+std::string CookieSessionStorage::cookieValue(const Session& session)
+{
+    const DerivedKey& key = keys_.front();
+    int64_t expiry = std::chrono::duration_cast<std::chrono::seconds>(
+        session.expiryTime().time_since_epoch()).count();
+    std::string payload = encodeSession(session, expiry);
+
+    std::string cookie = encrypt_ ? "e1." : "v1.";
+    cookie += key.id;
+    cookie += '.';
+    if (encrypt_)
+    {
+        std::string sealed;
+        if (!encrypt(key, payload, &sealed))
+        {
+            LOG_ERROR << "Failed to encrypt session " << session.getId();
+            return std::string();
+        }
+        cookie += base64UrlEncode(sealed);
+    }
+    else
+    {
+        cookie += base64UrlEncode(payload);
+    }
+    std::string mac = sign(key, cookie);
+    cookie += '.';
+    cookie += base64UrlEncode(mac);
+
+    if (cookie.size() > kMaxCookieLength)
+    {
+        LOG_ERROR << "Session cookie is " << cookie.size() << " bytes, browsers may drop it";
+    }
+    return cookie;
+}
+
+std::shared_ptr<Session> CookieSessionStorage::load(const std::string& cookie)
+{
+    // <模式>.<密钥 id>.<数据>.<签名>
+    size_t first = cookie.find('.');
+    size_t second = first == std::string::npos ? first : cookie.find('.', first + 1);
+    size_t last = cookie.rfind('.');
+    if (second == std::string::npos || last == second)
+    {
+        return nullptr;
+    }
+    std::string_view view(cookie);
+    std::string_view mode = view.substr(0, first);
+    bool encrypted = mode == "e1";
+    if (!encrypted && mode != "v1")
+    {
+        return nullptr;
+    }
+    const DerivedKey* key = findKey(view.substr(first + 1, second - first - 1));
+    if (key == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::string mac;
+    if (!base64UrlDecode(view.substr(last + 1), &mac))
+    {
+        return nullptr;
+    }
+    std::string expected = sign(*key, view.substr(0, last));
+    if (mac.size() != expected.size() || CRYPTO_memcmp(mac.data(), expected.data(), mac.size()) != 0)
+    {
+        LOG_WARN << "Session cookie signature mismatch";
+        return nullptr;
+    }
+
+    std::string body;
+    std::string payload;
+    if (!base64UrlDecode(view.substr(second + 1, last - second - 1), &body))
+    {
+        return nullptr;
+    }
+    if (encrypted)
+    {
+        if (!decrypt(*key, body, &payload))
+        {
+            return nullptr;
+        }
+    }
+    else
+    {
+        payload.swap(body);
+    }
+
+    std::string_view data(payload);
+    uint64_t expiry = 0;
+    if (!readNumber(&data, '\n', &expiry))
+    {
+        return nullptr;
+    }
+    auto expiryTime = std::chrono::system_clock::time_point(std::chrono::seconds(expiry));
+    if (std::chrono::system_clock::now() > expiryTime)
+    {
+        return nullptr;
+    }
+    size_t newline = data.find('\n');
+    if (newline == std::string_view::npos)
+    {
+        return nullptr;
+    }
+
+    auto session = std::make_shared<Session>(std::string(data.substr(0, newline)), nullptr);
+    data.remove_prefix(newline + 1);
+    if (!session->decodeValues(data))
+    {
+        return nullptr;
+    }
+    // 用旧密钥签发的会话按已到期处理，本次请求结束时用新密钥续签
+    session->setStoredExpiry(key == &keys_.front() ? expiryTime : std::chrono::system_clock::time_point());
+    return session;
+}
+
+bool CookieSessionStorage::touch(const std::shared_ptr<Session>& session)
+{
+    auto remaining = session->storedExpiry() - std::chrono::system_clock::now();
+    return remaining < std::chrono::seconds(session->maxAge()) / 2;
+}
+
+} // namespace session
+} // namespace http
@@ -0,0 +1,879 @@
+#include "../../include/session/MmapSessionStorage.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <thread>
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+namespace session
+{
+
+namespace
+{
+
+const char     kMagic[8] = { 'H', 'S', 'E', 'S', 'S', 'I', 'O', 'N' };
+const uint32_t kVersion = 1;
+const uint32_t kNoSlot = 0xFFFFFFFF;
+const size_t   kNotFound = static_cast<size_t>(-1);
+// 槽的状态字
+const uint32_t kFree = 0;
+const uint32_t kHead = 0x44414548;     // "HEAD"
+const uint32_t kOverflow = 0x5746564F; // "OVFW"
+// 预留的地址空间，决定文件的最大尺寸；只占虚拟地址，不占内存
+const size_t   kReservedBytes = size_t(64) << 30;
+const size_t   kMaxShards = 256;
+// removeExpired 每次在每个分片中至少检查的索引项数；按每秒一次计，约 kSweepTicks 次扫完一遍
+const size_t   kMinScanStep = 256;
+const size_t   kSweepTicks = 60;
+
+struct FileHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t slotSize;
+};
+
+} // namespace
+
+struct MmapSessionStorage::SlotHeader
+{
+    uint32_t state;    // kFree / kHead / kOverflow，头槽最后写入
+    uint32_t crc;      // 头槽：seq、length、idLength 和整条记录数据的 CRC32
+    uint64_t seq;      // 写入序号，溢出槽与所属头槽相同
+    int64_t  expiry;   // 头槽：过期时间（秒），不参与校验
+    uint32_t length;   // 头槽：记录总长度（id + 字段编码）；溢出槽：本槽中的数据长度
+    uint32_t next;     // 下一个溢出槽，kNoSlot 表示结束
+    uint16_t idLength; // 头槽：会话 id 的长度，id 总是完整地放在头槽中
+    uint16_t reserved[3];
+};
+
+MmapSessionStorage::MmapSessionStorage(const std::string& path, size_t slotSize, size_t initialSlots,
+                                       double lockTimeoutSeconds, size_t shardCount)
+    : path_(path)
+    , fd_(-1)
+    , base_(nullptr)
+    , reservedSize_(kReservedBytes)
+    , slotSize_(0)
+    , slotCount_(0)
+    , nextSeq_(1)
+    , overflowRecords_(0)
+    , shardMask_(0)
+{
+    static_assert(sizeof(SlotHeader) == 40, "slot header layout changed");
+    size_t count = 1;
+    while (count < std::min(std::max<size_t>(shardCount, 1), kMaxShards))
+    {
+        count <<= 1;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    shardMask_ = count - 1;
+
+    // 不退化成不持久化的内存映射：那样重启后所有玩家都要重新登录，而且不容易被发现
+    if (!open(slotSize, initialSlots, lockTimeoutSeconds))
+    {
+        LOG_FATAL << "Session file " << path_ << " unavailable";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    recover();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    size_t sessions = 0;
+    for (const auto& shard : shards_)
+    {
+        sessions += shard->size;
+    }
+    LOG_INFO << "Recovered " << sessions << " sessions from " << path_
+             << " in " << elapsed.count() << "ms";
+}
+
+MmapSessionStorage::~MmapSessionStorage()
+{
+    if (base_ != nullptr)
+    {
+        ::munmap(base_, reservedSize_);
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+}
+
+bool MmapSessionStorage::open(size_t slotSize, size_t initialSlots, double lockTimeoutSeconds)
+{
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0)
+    {
+        LOG_ERROR << "open " << path_ << " failed, errno=" << errno;
+        return false;
+    }
+    if (!lockFile(lockTimeoutSeconds))
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+    {
+        return false;
+    }
+
+    FileHeader header;
+    uint32_t count = 0;
+    if (st.st_size == 0)
+    {
+        slotSize_ = slotSizeFor(slotSize);
+        count = alignedSlotCount(uint64_t(std::max<size_t>(initialSlots, 1)) + 1);
+        if (!allocate(slotSize_ * count))
+        {
+            return false;
+        }
+        std::memcpy(header.magic, kMagic, sizeof kMagic);
+        header.version = kVersion;
+        header.slotSize = static_cast<uint32_t>(slotSize_);
+        if (::pwrite(fd_, &header, sizeof header, 0) != static_cast<ssize_t>(sizeof header))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (::pread(fd_, &header, sizeof header, 0) != static_cast<ssize_t>(sizeof header) ||
+            std::memcmp(header.magic, kMagic, sizeof kMagic) != 0 || header.version != kVersion ||
+            header.slotSize != slotSizeFor(header.slotSize))
+        {
+            LOG_ERROR << path_ << " is not a session file";
+            return false;
+        }
+        slotSize_ = header.slotSize;
+        // 忽略扩容时没写完的尾部，再补齐到整页
+        uint64_t slots = st.st_size / slotSize_;
+        count = alignedSlotCount(slots);
+        if (slots < 2 || count < slots)
+        {
+            LOG_ERROR << path_ << " has an unsupported size " << st.st_size;
+            return false;
+        }
+        // 旧版本用 ftruncate 扩容的文件可能有空洞，这里补上
+        if (!allocate(slotSize_ * count))
+        {
+            return false;
+        }
+    }
+
+    void* base = ::mmap(nullptr, reservedSize_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        LOG_ERROR << "Reserving address space for " << path_ << " failed, errno=" << errno;
+        return false;
+    }
+    base_ = static_cast<char*>(base);
+    // 启动时要顺序扫描整个文件，一次性建立映射比逐页缺页快得多
+    if (!mapFile(0, slotSize_ * count, true))
+    {
+        return false;
+    }
+    slotCount_.store(count);
+    return true;
+}
+
+// 把文件的 [offset, offset + length) 映射到预留地址空间的相同偏移处，offset 和 length 按页对齐
+bool MmapSessionStorage::mapFile(size_t offset, size_t length, bool populate)
+{
+    int flags = MAP_SHARED | MAP_FIXED | (populate ? MAP_POPULATE : 0);
+    void* addr = ::mmap(base_ + offset, length, PROT_READ | PROT_WRITE, flags, fd_, static_cast<off_t>(offset));
+    if (addr == MAP_FAILED)
+    {
+        LOG_ERROR << "mmap " << path_ << " failed, errno=" << errno;
+        // MAP_FIXED 失败时这段地址的状态不确定，重新占住，避免被别的映射拿走
+        ::mmap(base_ + offset, length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+        return false;
+    }
+    return true;
+}
+
+// 把槽数向上取整，使文件尺寸是页大小的整数倍，不超过预留的地址空间
+uint32_t MmapSessionStorage::alignedSlotCount(uint64_t count) const
+{
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    uint64_t unit = page / std::gcd(slotSize_, page);
+    uint64_t limit = std::min<uint64_t>(kNoSlot, reservedSize_ / slotSize_) / unit * unit;
+    return static_cast<uint32_t>(std::min((count + unit - 1) / unit * unit, limit));
+}
+
+// 同一时间只能有一个进程使用会话文件。滚动发布时新旧进程会短暂重叠，
+// 新进程每 100ms 重试一次，等旧进程退出（进程退出时锁自动释放），超时返回 false
+bool MmapSessionStorage::lockFile(double timeoutSeconds)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeoutSeconds);
+    bool waiting = false;
+    while (::flock(fd_, LOCK_EX | LOCK_NB) != 0)
+    {
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno != EWOULDBLOCK)
+        {
+            LOG_ERROR << "flock " << path_ << " failed, errno=" << errno;
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            LOG_ERROR << path_ << " is still locked by another process after " << timeoutSeconds << "s";
+            return false;
+        }
+        if (!waiting)
+        {
+            LOG_WARN << path_ << " is locked by another process, waiting for it to exit";
+            waiting = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return true;
+}
+
+// 顺序扫描所有槽建立各分片的索引。只检查槽头，记录内容在第一次 load 时校验；
+// 同一个会话有两条记录时（保存到一半时崩溃）校验两条，保留校验通过、序号大的一条。
+// 只在构造函数中调用，不加锁
+void MmapSessionStorage::recover()
+{
+    int64_t now = nowSeconds();
+    size_t cap = capacity();
+    uint32_t slotCount = slotCount_.load();
+    uint64_t nextSeq = 1;
+    std::vector<std::pair<uint32_t, uint32_t>> heads;
+    std::vector<size_t> counts(shards_.size(), 0);
+    for (uint32_t i = 1; i < slotCount; ++i)
+    {
+        SlotHeader* header = slotAt(i);
+        if (header->state != kHead && header->state != kOverflow)
+        {
+            continue;
+        }
+        nextSeq = std::max(nextSeq, header->seq + 1);
+        if (header->state != kHead)
+        {
+            continue;
+        }
+        if (header->expiry <= now || header->idLength == 0 ||
+            header->idLength > std::min<size_t>(cap, header->length))
+        {
+            header->state = kFree;
+            continue;
+        }
+        uint32_t hash = hashOf(idAt(i));
+        heads.emplace_back(i, hash);
+        ++counts[(hash >> 24) & shardMask_];
+    }
+    nextSeq_.store(nextSeq);
+
+    for (size_t s = 0; s < shards_.size(); ++s)
+    {
+        size_t size = 16;
+        while (size < counts[s] * 2)
+        {
+            size <<= 1;
+        }
+        shards_[s]->index.assign(size, IndexEntry{});
+    }
+
+    std::vector<bool> used(slotCount, false);
+    std::vector<uint32_t> slots;
+    for (auto [head, hash] : heads)
+    {
+        SlotHeader* header = slotAt(head);
+        slots.clear();
+        if (header->next == kNoSlot)
+        {
+            slots.push_back(head);
+        }
+        else if (!readRecord(head, nullptr, &slots))
+        {
+            header->state = kFree;
+            continue;
+        }
+
+        Shard& shard = shardFor(hash);
+        size_t pos = find(shard, idAt(head), hash);
+        if (pos == kNotFound)
+        {
+            insert(shard, head, hash, nullptr);
+        }
+        else
+        {
+            uint32_t other = shard.index[pos].slot;
+            bool newer = header->seq > slotAt(other)->seq;
+            // 序号大的一条校验不通过（写了一半）时用另一条
+            if (!readRecord(newer ? head : other, nullptr, nullptr))
+            {
+                newer = !newer;
+            }
+            if (!newer)
+            {
+                header->state = kFree;
+                continue;
+            }
+            std::vector<uint32_t> stale;
+            readRecord(other, nullptr, &stale);
+            for (uint32_t slot : stale)
+            {
+                used[slot] = false;
+            }
+            slotAt(other)->state = kFree;
+            shard.index[pos].slot = head;
+        }
+        for (uint32_t slot : slots)
+        {
+            used[slot] = true;
+        }
+    }
+
+    // 倒序压入，分配时先用文件前部的槽
+    for (uint32_t i = slotCount - 1; i >= 1; --i)
+    {
+        if (!used[i])
+        {
+            freeSlots_.push_back(i);
+        }
+    }
+}
+
+// 文件按倍数扩容，保证至少有 minFree 个空闲槽。调用方持有 allocMutex_；
+// 只映射新增的部分，已有槽的地址不变，其他分片可以同时读写已有的槽
+bool MmapSessionStorage::grow(size_t minFree)
+{
+    uint32_t slotCount = slotCount_.load();
+    uint32_t count = alignedSlotCount(std::max<uint64_t>(uint64_t(slotCount) * 2, uint64_t(slotCount) + minFree));
+    if (count < slotCount || count - slotCount < minFree)
+    {
+        LOG_ERROR << "Session file " << path_ << " is full";
+        return false;
+    }
+    size_t oldSize = slotSize_ * slotCount;
+    size_t size = slotSize_ * count;
+    if (!allocate(size) || !mapFile(oldSize, size - oldSize, false))
+    {
+        return false;
+    }
+
+    // 新槽放在空闲表的底部，先复用刚释放的槽
+    std::vector<uint32_t> added;
+    added.reserve(count - slotCount);
+    for (uint32_t i = count - 1; i >= slotCount; --i)
+    {
+        added.push_back(i);
+    }
+    freeSlots_.insert(freeSlots_.begin(), added.begin(), added.end());
+    slotCount_.store(count);
+    return true;
+}
+
+// 为文件的 [0, size) 分配磁盘块。ftruncate 得到的是稀疏文件，磁盘满时第一次写入没有块的页会触发 SIGBUS
+// 直接杀死进程；posix_fallocate 在这里就返回错误，按普通的写入失败处理
+bool MmapSessionStorage::allocate(size_t size)
+{
+    int err = ::posix_fallocate(fd_, 0, static_cast<off_t>(size));
+    if (err != 0)
+    {
+        LOG_ERROR << "posix_fallocate " << path_ << " to " << size << " bytes failed, errno=" << err;
+        return false;
+    }
+    return true;
+}
+
+MmapSessionStorage::SlotHeader* MmapSessionStorage::slotAt(uint32_t index) const
+{
+    return reinterpret_cast<SlotHeader*>(base_ + size_t(index) * slotSize_);
+}
+
+std::string_view MmapSessionStorage::idAt(uint32_t head) const
+{
+    const SlotHeader* header = slotAt(head);
+    return std::string_view(reinterpret_cast<const char*>(header + 1), header->idLength);
+}
+
+size_t MmapSessionStorage::capacity() const
+{
+    return slotSize_ - sizeof(SlotHeader);
+}
+
+// 写入一条新记录，返回头槽号；失败时返回 kNoSlot，旧记录不受影响。
+// 只在分配槽时持有 allocMutex_，拿到的槽归调用方所在的分片独占，在锁外写入
+uint32_t MmapSessionStorage::writeRecord(const std::string& sessionId, const std::string& payload, int64_t expiry)
+{
+    size_t cap = capacity();
+    size_t total = sessionId.size() + payload.size();
+    size_t count = std::max<size_t>(1, (total + cap - 1) / cap);
+    if (sessionId.empty() || sessionId.size() > cap || sessionId.size() > 0xFFFF || total > 0xFFFFFFFF)
+    {
+        LOG_ERROR << "Session " << sessionId << " cannot be persisted";
+        return kNoSlot;
+    }
+
+    std::vector<uint32_t> slots(count);
+    {
+        std::lock_guard<std::mutex> lock(allocMutex_);
+        if (freeSlots_.size() < count && !grow(count))
+        {
+            return kNoSlot;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            slots[i] = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+    }
+    if (count > 1)
+    {
+        overflowRecords_.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t seq = nextSeq_.fetch_add(1, std::memory_order_relaxed);
+
+    // 记录数据是 id 和字段编码拼在一起，按槽容量切块
+    auto copyChunk = [&](char* dst, size_t offset, size_t length) {
+        if (offset < sessionId.size())
+        {
+            size_t n = std::min(length, sessionId.size() - offset);
+            std::memcpy(dst, sessionId.data() + offset, n);
+            dst += n;
+            length -= n;
+            offset = 0;
+        }
+        else
+        {
+            offset -= sessionId.size();
+        }
+        std::memcpy(dst, payload.data() + offset, length);
+    };
+
+    for (size_t i = count - 1; i >= 1; --i)
+    {
+        SlotHeader* header = slotAt(slots[i]);
+        size_t offset = i * cap;
+        size_t length = std::min(cap, total - offset);
+        copyChunk(reinterpret_cast<char*>(header + 1), offset, length);
+        header->seq = seq;
+        header->expiry = 0;
+        header->length = static_cast<uint32_t>(length);
+        header->next = i + 1 < count ? slots[i + 1] : kNoSlot;
+        header->idLength = 0;
+        header->crc = 0;
+        header->state = kOverflow;
+    }
+
+    SlotHeader* head = slotAt(slots[0]);
+    head->state = kFree;
+    copyChunk(reinterpret_cast<char*>(head + 1), 0, std::min(cap, total));
+    head->seq = seq;
+    head->expiry = expiry;
+    head->length = static_cast<uint32_t>(total);
+    head->next = count > 1 ? slots[1] : kNoSlot;
+    head->idLength = static_cast<uint16_t>(sessionId.size());
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&head->seq), sizeof head->seq);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&head->length), sizeof head->length);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&head->idLength), sizeof head->idLength);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(sessionId.data()), static_cast<uInt>(sessionId.size()));
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(payload.data()), static_cast<uInt>(payload.size()));
+    head->crc = static_cast<uint32_t>(crc);
+
+    // 其余内容都写完之后才发布头槽
+    std::atomic_signal_fence(std::memory_order_release);
+    head->state = kHead;
+    return slots[0];
+}
+
+// 沿溢出链读出记录并校验 CRC；data 为空时只校验，slots 不为空时收集记录占用的槽
+bool MmapSessionStorage::readRecord(uint32_t head, std::string* data, std::vector<uint32_t>* slots) const
+{
+    const SlotHeader* header = slotAt(head);
+    size_t cap = capacity();
+    size_t total = header->length;
+    if (data != nullptr)
+    {
+        data->clear();
+        data->reserve(total);
+    }
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&header->seq), sizeof header->seq);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&header->length), sizeof header->length);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&header->idLength), sizeof header->idLength);
+
+    uint64_t seq = header->seq;
+    uint32_t index = head;
+    size_t done = 0;
+    while (true)
+    {
+        const SlotHeader* slot = slotAt(index);
+        size_t length = index == head ? std::min(cap, total) : slot->length;
+        if (length > cap || length > total - done || (index != head && length == 0))
+        {
+            return false;
+        }
+        const char* chunk = reinterpret_cast<const char*>(slot + 1);
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(chunk), static_cast<uInt>(length));
+        if (data != nullptr)
+        {
+            data->append(chunk, length);
+        }
+        if (slots != nullptr)
+        {
+            slots->push_back(index);
+        }
+        done += length;
+        if (done == total)
+        {
+            break;
+        }
+        // 溢出槽必须属于同一次写入，防止链到已被复用的槽
+        index = slot->next;
+        if (index == 0 || index >= slotCount_.load() || slotAt(index)->state != kOverflow || slotAt(index)->seq != seq)
+        {
+            return false;
+        }
+    }
+    return static_cast<uint32_t>(crc) == header->crc;
+}
+
+// 先释放溢出槽再释放头槽；只释放序号相同的溢出槽，链损坏时也不会误放别的记录的槽
+void MmapSessionStorage::freeRecord(uint32_t head)
+{
+    if (head == kNoSlot)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    uint32_t slotCount = slotCount_.load();
+    SlotHeader* header = slotAt(head);
+    uint32_t index = header->next;
+    while (index != 0 && index < slotCount && slotAt(index)->state == kOverflow &&
+           slotAt(index)->seq == header->seq)
+    {
+        SlotHeader* slot = slotAt(index);
+        slot->state = kFree;
+        freeSlots_.push_back(index);
+        index = slot->next;
+    }
+    header->state = kFree;
+    freeSlots_.push_back(head);
+}
+
+std::shared_ptr<Session> MmapSessionStorage::decode(uint32_t head) const
+{
+    std::string data;
+    std::string_view sessionId = idAt(head);
+    if (!readRecord(head, &data, nullptr))
+    {
+        LOG_ERROR << "Session record " << sessionId << " is corrupted";
+        return nullptr;
+    }
+    auto session = std::make_shared<Session>(std::string(sessionId), nullptr);
+    if (!session->decodeValues(std::string_view(data).substr(sessionId.size())))
+    {
+        LOG_ERROR << "Session record " << sessionId << " is malformed";
+        return nullptr;
+    }
+    return session;
+}
+
+std::string_view MmapSessionStorage::idOf(const IndexEntry& entry) const
+{
+    return entry.slot == kNoSlot ? std::string_view(entry.session->getId()) : idAt(entry.slot);
+}
+
+// 已经解码的会话以内存中的过期时间为准（精确到纳秒，文件中按秒向上取整）
+bool MmapSessionStorage::expired(const IndexEntry& entry, int64_t now) const
+{
+    return entry.session ? entry.session->isExpired() : slotAt(entry.slot)->expiry <= now;
+}
+
+// 用哈希的高位选分片，低位决定分片索引中的位置，两者互不相关
+MmapSessionStorage::Shard& MmapSessionStorage::shardFor(uint32_t hash) const
+{
+    return *shards_[(hash >> 24) & shardMask_];
+}
+
+size_t MmapSessionStorage::find(const Shard& shard, std::string_view sessionId, uint32_t hash) const
+{
+    size_t mask = shard.index.size() - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask)
+    {
+        const IndexEntry& entry = shard.index[pos];
+        if (entry.slot == 0)
+        {
+            return kNotFound;
+        }
+        if (entry.hash == hash && idOf(entry) == sessionId)
+        {
+            return pos;
+        }
+    }
+}
+
+void MmapSessionStorage::insert(Shard& shard, uint32_t slot, uint32_t hash, std::shared_ptr<Session> session)
+{
+    // 负载因子不超过 1/2
+    if ((shard.size + 1) * 2 > shard.index.size())
+    {
+        rehash(shard, shard.index.size() * 2);
+    }
+    size_t mask = shard.index.size() - 1;
+    size_t pos = hash & mask;
+    while (shard.index[pos].slot != 0)
+    {
+        pos = (pos + 1) & mask;
+    }
+    if (session)
+    {
+        ++shard.loaded;
+    }
+    if (slot == kNoSlot)
+    {
+        ++shard.unpersisted;
+    }
+    shard.index[pos] = IndexEntry{ slot, hash, std::move(session) };
+    ++shard.size;
+}
+
+// 删除后把探测序列中后面的项前移，保证查找遇到空位即可停止
+void MmapSessionStorage::erase(Shard& shard, size_t pos)
+{
+    std::vector<IndexEntry>& index = shard.index;
+    if (index[pos].session)
+    {
+        --shard.loaded;
+    }
+    if (index[pos].slot == kNoSlot)
+    {
+        --shard.unpersisted;
+    }
+    index[pos] = IndexEntry{};
+    --shard.size;
+
+    size_t mask = index.size() - 1;
+    size_t hole = pos;
+    for (size_t next = (pos + 1) & mask; index[next].slot != 0; next = (next + 1) & mask)
+    {
+        size_t home = index[next].hash & mask;
+        // home 落在 (hole, next] 之间的项不能前移，否则从 home 开始找不到它
+        bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays)
+        {
+            index[hole] = std::move(index[next]);
+            index[next] = IndexEntry{};
+            hole = next;
+        }
+    }
+}
+
+void MmapSessionStorage::rehash(Shard& shard, size_t size)
+{
+    std::vector<IndexEntry> old(size);
+    old.swap(shard.index);
+    size_t mask = size - 1;
+    for (IndexEntry& entry : old)
+    {
+        if (entry.slot == 0)
+        {
+            continue;
+        }
+        size_t pos = entry.hash & mask;
+        while (shard.index[pos].slot != 0)
+        {
+            pos = (pos + 1) & mask;
+        }
+        shard.index[pos] = std::move(entry);
+    }
+}
+
+size_t MmapSessionStorage::slotSizeFor(size_t requested)
+{
+    // 按 8 字节对齐，至少能放下槽头和一个典型的会话 id
+    return std::max<size_t>((requested + 7) & ~size_t(7), sizeof(SlotHeader) + 64);
+}
+
+uint32_t MmapSessionStorage::hashOf(std::string_view sessionId)
+{
+    return static_cast<uint32_t>(std::hash<std::string_view>()(sessionId));
+}
+
+int64_t MmapSessionStorage::expirySeconds(const Session& session)
+{
+    auto expiry = session.expiryTime().time_since_epoch();
+    return std::chrono::ceil<std::chrono::seconds>(expiry).count();
+}
+
+int64_t MmapSessionStorage::nowSeconds()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::seconds>(now).count();
+}
+
+void MmapSessionStorage::save(std::shared_ptr<Session> session)
+{
+    // 编码在锁外完成
+    std::string payload;
+    session->encodeValues(&payload);
+    int64_t expiry = expirySeconds(*session);
+    uint32_t hash = hashOf(session->getId());
+    Shard& shard = shardFor(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 写入文件失败（磁盘满、记录过大）时会话仍然保存在内存中，本进程内照常使用：
+    // 已有的会话保留文件中的旧记录，重启后回到上一次保存的状态；新会话只在内存中，下次 save 时再尝试写入
+    uint32_t slot = writeRecord(session->getId(), payload, expiry);
+    size_t pos = find(shard, session->getId(), hash);
+    if (pos == kNotFound)
+    {
+        insert(shard, slot, hash, std::move(session));
+        return;
+    }
+    IndexEntry& entry = shard.index[pos];
+    if (!entry.session)
+    {
+        ++shard.loaded;
+    }
+    entry.session = std::move(session);
+    if (slot == kNoSlot)
+    {
+        return;
+    }
+    if (entry.slot == kNoSlot)
+    {
+        --shard.unpersisted;
+    }
+    freeRecord(entry.slot);
+    entry.slot = slot;
+}
+
+std::shared_ptr<Session> MmapSessionStorage::load(const std::string& sessionId)
+{
+    uint32_t hash = hashOf(sessionId);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t pos = find(shard, sessionId, hash);
+    if (pos == kNotFound)
+    {
+        return nullptr;
+    }
+    IndexEntry& entry = shard.index[pos];
+    if (expired(entry, nowSeconds()))
+    {
+        freeRecord(entry.slot);
+        erase(shard, pos);
+        return nullptr;
+    }
+    if (!entry.session)
+    {
+        // 启动后第一次访问，从文件中解码
+        entry.session = decode(entry.slot);
+        if (!entry.session)
+        {
+            freeRecord(entry.slot);
+            erase(shard, pos);
+            return nullptr;
+        }
+        ++shard.loaded;
+    }
+    return entry.session;
+}
+
+void MmapSessionStorage::remove(const std::string& sessionId)
+{
+    uint32_t hash = hashOf(sessionId);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t pos = find(shard, sessionId, hash);
+    if (pos != kNotFound)
+    {
+        freeRecord(shard.index[pos].slot);
+        erase(shard, pos);
+    }
+}
+
+bool MmapSessionStorage::touch(const std::shared_ptr<Session>& session)
+{
+    int64_t expiry = expirySeconds(*session);
+    uint32_t hash = hashOf(session->getId());
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t pos = find(shard, session->getId(), hash);
+    if (pos != kNotFound && shard.index[pos].slot != kNoSlot)
+    {
+        // 对齐的 8 字节写入，不会被撕裂
+        slotAt(shard.index[pos].slot)->expiry = expiry;
+    }
+    return false;
+}
+
+// 不再每分钟在一把锁下扫描整个索引：每次在每个分片中从上次停下的位置接着检查一段，
+// 检查的项数与分片大小成比例且有上限，请求线程最多等待一个分片的一小段扫描
+void MmapSessionStorage::removeExpired()
+{
+    ::msync(base_, slotSize_ * slotCount_.load(), MS_ASYNC);
+
+    int64_t now = nowSeconds();
+    for (const auto& ptr : shards_)
+    {
+        Shard& shard = *ptr;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size_t mask = shard.index.size() - 1;
+        size_t step = std::min(shard.index.size(), std::max(kMinScanStep, shard.index.size() / kSweepTicks + 1));
+        size_t pos = shard.cursor & mask;
+        for (size_t i = 0; i < step; ++i)
+        {
+            const IndexEntry& entry = shard.index[pos];
+            if (entry.slot != 0 && expired(entry, now))
+            {
+                // 后面的项会前移到 pos，留在原地再检查一次
+                freeRecord(entry.slot);
+                erase(shard, pos);
+            }
+            else
+            {
+                pos = (pos + 1) & mask;
+            }
+        }
+        shard.cursor = pos;
+    }
+}
+
+MmapSessionStorage::Stats MmapSessionStorage::stats() const
+{
+    Stats stats;
+    for (const auto& ptr : shards_)
+    {
+        std::lock_guard<std::mutex> lock(ptr->mutex);
+        stats.sessions += ptr->size;
+        stats.loaded += ptr->loaded;
+        stats.unpersisted += ptr->unpersisted;
+    }
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    stats.slots = slotCount_.load() - 1;
+    stats.freeSlots = freeSlots_.size();
+    stats.overflowRecords = overflowRecords_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace session
+} // namespace http
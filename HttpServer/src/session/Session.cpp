@@ -2,11 +2,36 @@
 
 #include "../include/session/SessionManager.h"
 
+#include <charconv>
+
 namespace http
 {
 namespace session
 {
 
+namespace
+{
+
+bool readString(std::string_view* data, std::string_view* value)
+{
+    size_t colon = data->find(':');
+    if (colon == std::string_view::npos || colon == 0)
+    {
+        return false;
+    }
+    size_t length = 0;
+    auto result = std::from_chars(data->data(), data->data() + colon, length);
+    if (result.ec != std::errc() || result.ptr != data->data() + colon || length > data->size() - colon - 1)
+    {
+        return false;
+    }
+    *value = data->substr(colon + 1, length);
+    data->remove_prefix(colon + 1 + length);
+    return true;
+}
+
+} // namespace
+
 Session::Session(const std::string& sessionId, SessionManager* sessionManager, int maxAge)
     : sessionId_(sessionId)
     , maxAge_(maxAge)
@@ -18,29 +43,33 @@ Session::Session(const std::string& sessionId, SessionManager* sessionManager, i
 // 检查会话是否已过期
 bool Session::isExpired() const
 {
-    return std::chrono::system_clock::now() > expiryTime_;
+    return std::chrono::system_clock::now() > expiryTime();
 }
 
 // 刷新会话的过期时间
 void Session::refresh()
 {
-    expiryTime_ = std::chrono::system_clock::now() + std::chrono::seconds(maxAge_);
+    auto expiry = std::chrono::system_clock::now() + std::chrono::seconds(maxAge_);
+    expiryTime_.store(expiry.time_since_epoch().count(), std::memory_order_relaxed);
 }
 
 // 设置会话数据
 void Session::setValue(const std::string& key, const std::string& value)
 {
-    data_[key] = value;
-    // 如果设置了manager，自动保存更改
-    if (sessionManager_)
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = data_.find(key);
+    if (it != data_.end() && it->second == value)
     {
-        sessionManager_->updateSession(shared_from_this());
+        return;
     }
+    data_[key] = value;
+    dirtyKeys_.insert(key);
 }
 
 // 获取会话数据
 std::string Session::getValue(const std::string& key) const
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = data_.find(key);
     return it != data_.end() ? it->second : std::string();
 }
@@ -48,14 +77,73 @@ std::string Session::getValue(const std::string& key) const
 // 删除会话数据
 void Session::remove(const std::string& key)
 {
-    data_.erase(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_.erase(key) > 0)
+    {
+        dirtyKeys_.insert(key);
+    }
 }
 
 // 清空会话数据
 void Session::clear()
 {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : data_)
+    {
+        dirtyKeys_.insert(entry.first);
+    }
     data_.clear();
 }
 
+std::unordered_map<std::string, std::string> Session::values() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_;
+}
+
+bool Session::isDirty() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !dirtyKeys_.empty();
+}
+
+std::unordered_set<std::string> Session::takeDirtyKeys()
+{
+    std::unordered_set<std::string> keys;
+    std::lock_guard<std::mutex> lock(mutex_);
+    keys.swap(dirtyKeys_);
+    return keys;
+}
+
+void Session::encodeValues(std::string* out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : data_)
+    {
+        *out += std::to_string(entry.first.size());
+        *out += ':';
+        *out += entry.first;
+        *out += std::to_string(entry.second.size());
+        *out += ':';
+        *out += entry.second;
+    }
+}
+
+bool Session::decodeValues(std::string_view data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!data.empty())
+    {
+        std::string_view name;
+        std::string_view value;
+        if (!readString(&data, &name) || !readString(&data, &value))
+        {
+            return false;
+        }
+        data_[std::string(name)] = std::string(value);
+    }
+    return true;
+}
+
 } // namespace session
 } // namespace http
\ No newline at end of file
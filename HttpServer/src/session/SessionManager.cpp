@@ -8,15 +8,19 @@ namespace http
 namespace session
 {
 
-// 初始化会话管理器，设置会话存储对象和随机数生成器
+// 初始化会话管理器，设置会话存储对象
 SessionManager::SessionManager(std::unique_ptr<SessionStorage> storage)
     : storage_(std::move(storage)) 
-    , rng_(std::random_device{}()) // 初始化随机数生成器，用于生成随机的会话ID
 {}
 
 // 从请求中获取或创建会话，也就是说，如果请求中包含会话ID，则从存储中加载会话，否则创建一个新的会话
-std::shared_ptr<Session> SessionManager::getSession(const HttpRequest& req, HttpResponse* resp)
+std::shared_ptr<Session> SessionManager::getSession(const HttpRequest& req, HttpResponse*)
 {   
+    if (req.session())
+    {
+        return req.session();
+    }
+
     std::string sessionId = getSessionIdFromCookie(req);
     
     std::shared_ptr<Session> session;
@@ -30,28 +34,63 @@ std::shared_ptr<Session> SessionManager::getSession(const HttpRequest& req, Http
     {
         sessionId = generateSessionId();
         session = std::make_shared<Session>(sessionId, this);
-        setSessionCookie(sessionId, resp);
+        session->setNew(true);
     }
     else 
     {
         session->setManager(this); // 为现有会话设置管理器
+        session->refresh();
     }
 
-    session->refresh();
-    storage_->save(session);  // 这里可能有问题，需要确保正确保存会话
+    req.setSession(session);
     return session;
 }
 
+void SessionManager::commit(const HttpRequest& req, HttpResponse* resp)
+{
+    std::shared_ptr<Session> session = req.session();
+    if (!session)
+    {
+        return;
+    }
+    req.setSession(nullptr);
+
+    if (session->isInvalidated())
+    {
+        if (!session->isNew())
+        {
+            expireSessionCookie(resp);
+        }
+        return;
+    }
+    // 先取出脏字段再保存（见 Session::takeDirtyKeys），保存的是取出之后会话的完整快照
+    if (!session->takeDirtyKeys().empty())
+    {
+        storage_->save(session);
+        if (session->isNew() || storage_->storesInCookie())
+        {
+            setSessionCookie(storage_->cookieValue(*session), resp);
+            session->setNew(false);
+        }
+    }
+    else if (!session->isNew() && storage_->touch(session))
+    {
+        setSessionCookie(storage_->cookieValue(*session), resp);
+    }
+}
+
 // 生成唯一的会话标识符，确保会话的唯一性和安全性
 std::string SessionManager::generateSessionId()
 {
+    // 多个 IO 线程同时创建会话，每个线程一个随机数生成器
+    thread_local std::mt19937 rng(std::random_device{}());
     std::stringstream ss;
     std::uniform_int_distribution<> dist(0, 15);
 
     // 生成32个字符的会话ID，每个字符是一个十六进制数字
     for (int i = 0; i < 32; ++i)
     {
-        ss << std::hex << dist(rng_);
+        ss << std::hex << dist(rng);
     }
     return ss.str();
 }
@@ -61,43 +100,42 @@ void SessionManager::destroySession(const std::string& sessionId)
     storage_->remove(sessionId);
 }
 
+void SessionManager::destroySession(Session& session)
+{
+    session.invalidate();
+    storage_->remove(session.getId());
+}
+
 void SessionManager::cleanExpiredSessions()
 {
-    // 注意：这个实现依赖于具体的存储实现
-    // 对于内存存储，可以在加载时检查是否过期
-    // 对于其他存储的实现，可能需要定期清理过期会话
+    storage_->removeExpired();
 }
 
 std::string SessionManager::getSessionIdFromCookie(const HttpRequest& req)
 {
-    std::string sessionId;
-    std::string cookie = req.getHeader("Cookie");
+    // 名字完全相同才匹配（不会误匹配 xsessionId=）
+    return std::string(req.cookie(kCookieName));
+}
 
-    if (!cookie.empty())
+void SessionManager::setSessionCookie(const std::string& sessionId, HttpResponse* resp)
+{
+    // 设置会话ID到响应头中，作为Cookie。SameSite=Lax：跨站的子请求和 POST 不带会话，减少 CSRF
+    std::string cookie = std::string(kCookieName) + "=" + sessionId + "; Path=/; HttpOnly; SameSite=Lax";
+    if (secureCookie_)
     {
-        size_t pos = cookie.find("sessionId=");
-        if (pos != std::string::npos)
-        {
-            pos += 10; // 跳过"sessionId="
-            size_t end = cookie.find(';', pos);
-            if (end != std::string::npos)
-            {
-                sessionId = cookie.substr(pos, end - pos);
-            }
-            else
-            {
-                sessionId = cookie.substr(pos);
-            }
-        }
+        cookie += "; Secure";
     }
-    
-    return sessionId;
+    resp->addHeader("Set-Cookie", cookie);
 }
 
-void SessionManager::setSessionCookie(const std::string& sessionId, HttpResponse* resp)
+void SessionManager::expireSessionCookie(HttpResponse* resp)
 {
-    // 设置会话ID到响应头中，作为Cookie
-    std::string cookie = "sessionId=" + sessionId + "; Path=/; HttpOnly";
+    // 属性与下发时一致，浏览器才会覆盖同一个 Cookie
+    std::string cookie = std::string(kCookieName) + "=; Path=/; Max-Age=0; HttpOnly; SameSite=Lax";
+    if (secureCookie_)
+    {
+        cookie += "; Secure";
+    }
     resp->addHeader("Set-Cookie", cookie);
 }
 
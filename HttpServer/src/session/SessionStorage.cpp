@@ -10,12 +10,14 @@ namespace session
 void MemorySessionStorage::save(std::shared_ptr<Session> session)
 {
     // 创建会话副本并存储
+    std::lock_guard<std::mutex> lock(mutex_);
     sessions_[session->getId()] = session;
 }
 
 // 通过会话ID从存储中加载会话
 std::shared_ptr<Session> MemorySessionStorage::load(const std::string& sessionId)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = sessions_.find(sessionId);
     if (it != sessions_.end())
     {
@@ -37,8 +39,26 @@ std::shared_ptr<Session> MemorySessionStorage::load(const std::string& sessionId
 // 通过会话ID从存储中移除会话
 void MemorySessionStorage::remove(const std::string& sessionId)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     sessions_.erase(sessionId);
 }
 
+// 遍历所有会话，移除已过期的
+void MemorySessionStorage::removeExpired()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = sessions_.begin(); it != sessions_.end();)
+    {
+        if (it->second->isExpired())
+        {
+            it = sessions_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 } // namespace session
 } // namespace http
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "../../include/session/ShardedSessionStorage.h"
+
+#include <chrono>
+#include <functional>
+
+namespace http
+{
+namespace session
+{
+
+ShardedSessionStorage::ShardedSessionStorage(size_t shardCount)
+{
+    size_t count = 1;
+    while (count < shardCount)
+    {
+        count <<= 1;
+    }
+    int64_t now = nowTick();
+    shards_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>(now));
+    }
+    shardMask_ = count - 1;
+}
+
+ShardedSessionStorage::Shard& ShardedSessionStorage::shardFor(const std::string& sessionId)
+{
+    return *shards_[std::hash<std::string>()(sessionId) & shardMask_];
+}
+
+// 先尝试加锁，失败时记一次竞争再阻塞等待
+std::unique_lock<std::mutex> ShardedSessionStorage::lock(Shard& shard)
+{
+    shard.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> guard(shard.mutex, std::try_to_lock);
+    if (!guard.owns_lock())
+    {
+        shard.contended.fetch_add(1, std::memory_order_relaxed);
+        guard.lock();
+    }
+    return guard;
+}
+
+// 过期时间向上取整到秒
+int64_t ShardedSessionStorage::expiryTick(const Session& session)
+{
+    auto expiry = session.expiryTime().time_since_epoch();
+    auto seconds = std::chrono::ceil<std::chrono::seconds>(expiry);
+    return seconds.count();
+}
+
+int64_t ShardedSessionStorage::nowTick()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::seconds>(now).count();
+}
+
+void ShardedSessionStorage::save(std::shared_ptr<Session> session)
+{
+    Shard& shard = shardFor(session->getId());
+    auto guard = lock(shard);
+    auto it = shard.sessions.find(session->getId());
+    if (it != shard.sessions.end())
+    {
+        // 已经有定时器，到期时再按最新的过期时间处理
+        it->second.session = std::move(session);
+        return;
+    }
+
+    int64_t tick = expiryTick(*session);
+    std::string sessionId = session->getId();
+    shard.sessions.emplace(sessionId, Entry{ std::move(session), tick });
+    shard.wheel.schedule(tick, std::move(sessionId));
+}
+
+std::shared_ptr<Session> ShardedSessionStorage::load(const std::string& sessionId)
+{
+    Shard& shard = shardFor(sessionId);
+    auto guard = lock(shard);
+    auto it = shard.sessions.find(sessionId);
+    if (it == shard.sessions.end())
+    {
+        return nullptr;
+    }
+    if (it->second.session->isExpired())
+    {
+        // 时间轮中的定时器找不到会话，到期时自动忽略
+        shard.sessions.erase(it);
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return it->second.session;
+}
+
+void ShardedSessionStorage::remove(const std::string& sessionId)
+{
+    Shard& shard = shardFor(sessionId);
+    auto guard = lock(shard);
+    shard.sessions.erase(sessionId);
+}
+
+void ShardedSessionStorage::removeExpired()
+{
+    int64_t now = nowTick();
+    for (auto& shardPtr : shards_)
+    {
+        Shard& shard = *shardPtr;
+        auto guard = lock(shard);
+        std::vector<std::pair<int64_t, std::string>> renewed;
+        shard.wheel.advance(now, [&shard, &renewed](std::string& sessionId, int64_t tick) {
+            auto it = shard.sessions.find(sessionId);
+            if (it == shard.sessions.end() || it->second.timerTick != tick)
+            {
+                // 会话已删除，或者已经有更新的定时器
+                return;
+            }
+            if (it->second.session->isExpired())
+            {
+                shard.sessions.erase(it);
+                shard.evictions.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // 期间被访问过，按新的过期时间重新挂上（推进结束后再插入，不影响本轮遍历）
+            it->second.timerTick = expiryTick(*it->second.session);
+            renewed.emplace_back(it->second.timerTick, std::move(sessionId));
+        });
+        for (auto& timer : renewed)
+        {
+            shard.wheel.schedule(timer.first, std::move(timer.second));
+        }
+    }
+}
+
+ShardedSessionStorage::Stats ShardedSessionStorage::stats() const
+{
+    Stats stats;
+    for (const auto& shardPtr : shards_)
+    {
+        Shard& shard = *shardPtr;
+        {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            stats.sessions += shard.sessions.size();
+        }
+        stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+        stats.acquisitions += shard.acquisitions.load(std::memory_order_relaxed);
+        stats.contended += shard.contended.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+} // namespace session
+} // namespace http
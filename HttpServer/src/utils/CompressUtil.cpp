@@ -0,0 +1,71 @@
+#include "../../include/utils/CompressUtil.h"
+
+#include <brotli/encode.h>
+#include <zlib.h>
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+
+bool CompressUtil::gzip(std::string_view input, int level, std::string* output)
+{
+    z_stream stream = {};
+    // windowBits 15 + 16：输出 gzip 格式（带 gzip 头和 CRC）
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        LOG_ERROR << "deflateInit2 failed";
+        return false;
+    }
+
+    output->resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+    stream.avail_out = static_cast<uInt>(output->size());
+
+    int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+    {
+        LOG_ERROR << "deflate failed, ret=" << ret;
+        return false;
+    }
+    output->resize(stream.total_out);
+    return true;
+}
+
+bool CompressUtil::brotli(std::string_view input, int quality, std::string* output)
+{
+    size_t size = BrotliEncoderMaxCompressedSize(input.size());
+    if (size == 0)
+    {
+        return false;
+    }
+    output->resize(size);
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               input.size(), reinterpret_cast<const uint8_t*>(input.data()),
+                               &size, reinterpret_cast<uint8_t*>(&(*output)[0])))
+    {
+        LOG_ERROR << "BrotliEncoderCompress failed";
+        return false;
+    }
+    output->resize(size);
+    return true;
+}
+
+bool CompressUtil::compressible(std::string_view contentType)
+{
+    // 去掉 "; charset=..." 之类的参数
+    contentType = contentType.substr(0, contentType.find(';'));
+    if (contentType.substr(0, 5) == "text/")
+    {
+        return true;
+    }
+    return contentType == "application/json" ||
+           contentType == "application/javascript" ||
+           contentType == "application/xml" ||
+           contentType == "image/svg+xml";
+}
+
+} // namespace http
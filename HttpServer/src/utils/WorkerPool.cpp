@@ -0,0 +1,136 @@
+#include "../../include/utils/WorkerPool.h"
+
+#include <muduo/base/Logging.h>
+
+namespace http
+{
+
+WorkerPool::WorkerPool(size_t threadNum, size_t maxQueued)
+    : maxQueued_(maxQueued)
+{
+    if (threadNum == 0)
+    {
+        threadNum = 1;
+    }
+    for (size_t i = 0; i < threadNum; ++i)
+    {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_)
+        {
+            return;
+        }
+        running_ = true;
+        stopped_ = false;
+    }
+    for (size_t i = 0; i < queues_.size(); ++i)
+    {
+        threads_.emplace_back(&WorkerPool::run, this, i);
+    }
+    LOG_INFO << "WorkerPool started with " << queues_.size() << " threads";
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        stopped_ = true;
+    }
+    cond_.notify_all();
+    for (auto& thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool WorkerPool::post(Task task)
+{
+    // 先占一个名额，超过上限再退回
+    if (queued_.fetch_add(1, std::memory_order_acq_rel) >= maxQueued_)
+    {
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+
+    Queue& queue = *queues_[next_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+    {
+        // 持有 mutex_ 放入任务：stop() 之后提交的任务不会再有线程执行，直接拒绝；
+        // 同时避免工作线程检查完条件、还没开始等待时错过唤醒
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    cond_.notify_one();
+    return true;
+}
+
+bool WorkerPool::take(size_t index, Task* task)
+{
+    for (size_t i = 0; i < queues_.size(); ++i)
+    {
+        Queue& queue = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+        // 自己的队列和窃取的队列都从头部取，先提交的任务先执行，窃取时不会让最早的任务一直被后来者插队
+        *task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::run(size_t index)
+{
+    Task task;
+    while (true)
+    {
+        if (take(index, &task))
+        {
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR << "WorkerPool task threw: " << e.what();
+            }
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 名额已占但任务还没放进队列时 queued_ 也大于 0，此时短暂地重试即可
+        cond_.wait(lock, [this] { return !running_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (!running_ && queued_.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace http
@@ -1,6 +1,8 @@
 #include "../../../include/utils/db/DbConnection.h"
 #include "../../../include/utils/db/DbException.h"
 #include <muduo/base/Logging.h>
+#include <mysql/errmsg.h>
+#include <mysql/mysqld_error.h>
 
 namespace http 
 {
@@ -10,11 +12,13 @@ namespace db
 DbConnection::DbConnection(const std::string& host,
                          const std::string& user,
                          const std::string& password,
-                         const std::string& database)
+                         const std::string& database,
+                         size_t statementCacheSize)
     : host_(host)
     , user_(user)
     , password_(password)
     , database_(database)
+    , statements_(statementCacheSize)
 {
     try 
     {
@@ -58,6 +62,7 @@ DbConnection::~DbConnection()
 
 bool DbConnection::ping() 
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     try 
     {
         // 不使用 getStmt，直接创建新的语句
@@ -74,6 +79,7 @@ bool DbConnection::ping()
 
 bool DbConnection::isValid() 
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     try 
     {
         if (!conn_) return false;
@@ -87,8 +93,25 @@ bool DbConnection::isValid()
     }
 }
 
+bool DbConnection::isStaleStatementError(int errorCode, bool idempotent)
+{
+    // CR_SERVER_GONE_ERROR：发送之前就发现连接已断开；ER_UNKNOWN_STMT_HANDLER：重连后语句已失效。
+    // 这两种情况语句都没有执行。CR_SERVER_LOST 发生在执行过程中，只有查询可以安全重试
+    return errorCode == CR_SERVER_GONE_ERROR ||
+           errorCode == ER_UNKNOWN_STMT_HANDLER ||
+           (idempotent && errorCode == CR_SERVER_LOST);
+}
+
 void DbConnection::reconnect() 
 {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reconnectLocked();
+}
+
+void DbConnection::reconnectLocked() 
+{
+    // 预处理语句属于旧的服务器会话，重连后全部失效
+    statements_.clear();
     try 
     {
         if (conn_) 
@@ -140,7 +163,7 @@ void DbConnection::cleanup()
         LOG_WARN << "Error cleaning up connection: " << e.what();
         try 
         {
-            reconnect();
+            reconnectLocked();
         } 
         catch (...) 
         {
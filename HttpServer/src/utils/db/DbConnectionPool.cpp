@@ -29,7 +29,8 @@ void DbConnectionPool::init(const std::string& host,
     // 创建连接
     for (size_t i = 0; i < poolSize; ++i) 
     {
-        connections_.push(createConnection());
+        allConnections_.push_back(createConnection());
+        connections_.push(allConnections_.back());
     }
 
     initialized_ = true;
@@ -101,38 +102,55 @@ std::shared_ptr<DbConnection> DbConnectionPool::getConnection()
     }
 }
 
+StatementCache::Stats DbConnectionPool::statementStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    StatementCache::Stats total;
+    for (const auto& conn : allConnections_)
+    {
+        total += conn->statementStats();
+    }
+    return total;
+}
+
 std::shared_ptr<DbConnection> DbConnectionPool::createConnection() 
 {
     return std::make_shared<DbConnection>(host_, user_, password_, database_);
 }
 
-// 修改检查连接的函数
+// 定期检查空闲连接。每次从空闲队列中取出一个连接检查，检查完再放回：
+// 已经借出的连接上可能还有没读完的结果集，重连会使它依赖的预处理语句失效，所以不检查借出的连接
 void DbConnectionPool::checkConnections() 
 {
     while (true) 
     {
         try 
         {
-            std::vector<std::shared_ptr<DbConnection>> connsToCheck;
+            size_t idle;
             {
-                std::unique_lock<std::mutex> lock(mutex_);
-                if (connections_.empty()) 
-                {
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
-                    continue;
-                }
-                
-                auto temp = connections_;
-                while (!temp.empty()) 
-                {
-                    connsToCheck.push_back(temp.front());
-                    temp.pop();
-                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                idle = connections_.size();
             }
-            
-            // 在锁外检查连接
-            for (auto& conn : connsToCheck) 
+            if (idle == 0) 
             {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+
+            for (size_t i = 0; i < idle; ++i) 
+            {
+                std::shared_ptr<DbConnection> conn;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (connections_.empty()) 
+                    {
+                        break;
+                    }
+                    conn = connections_.front();
+                    connections_.pop();
+                }
+
+                // 在锁外检查连接
                 if (!conn->ping()) 
                 {
                     try 
@@ -144,6 +162,12 @@ void DbConnectionPool::checkConnections()
                         LOG_ERROR << "Failed to reconnect: " << e.what();
                     }
                 }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    connections_.push(conn);
+                    cv_.notify_one();
+                }
             }
             
             std::this_thread::sleep_for(std::chrono::seconds(60));
@@ -0,0 +1,53 @@
+#include "../../../include/utils/db/QueryResult.h"
+#include "../../../include/utils/db/DbConnection.h"
+
+namespace http
+{
+namespace db
+{
+
+QueryResult::QueryResult(std::shared_ptr<DbConnection> lease, std::unique_ptr<sql::ResultSet> rs)
+    : lease_(std::move(lease))
+    , rs_(std::move(rs))
+    , row_(rs_.get())
+{
+}
+
+QueryResult::~QueryResult() = default;
+
+QueryResult::QueryResult(QueryResult&& other) noexcept
+    : lease_(std::move(other.lease_))
+    , rs_(std::move(other.rs_))
+    , row_(rs_.get())
+{
+    other.row_ = Row(nullptr);
+}
+
+QueryResult& QueryResult::operator=(QueryResult&& other) noexcept
+{
+    if (this != &other)
+    {
+        // 先释放自己的结果集和连接，顺序与析构一致
+        reset();
+        lease_ = std::move(other.lease_);
+        rs_ = std::move(other.rs_);
+        row_ = Row(rs_.get());
+        other.row_ = Row(nullptr);
+    }
+    return *this;
+}
+
+bool QueryResult::next()
+{
+    return rs_ && rs_->next();
+}
+
+void QueryResult::reset()
+{
+    row_ = Row(nullptr);
+    rs_.reset();
+    lease_.reset();
+}
+
+} // namespace db
+} // namespace http
@@ -0,0 +1,73 @@
+#include "../../../include/utils/db/StatementCache.h"
+
+namespace http
+{
+namespace db
+{
+
+StatementCache::StatementCache(size_t capacity)
+    : capacity_(capacity == 0 ? 1 : capacity)
+{
+    index_.reserve(capacity_);
+}
+
+sql::PreparedStatement* StatementCache::acquire(sql::Connection* conn, const std::string& sql)
+{
+    auto it = index_.find(std::string_view(sql));
+    if (it != index_.end())
+    {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        // 移到表头，splice 不改变节点地址，索引中的键仍然有效
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->stmt.get();
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    // 先准备语句：失败时抛出异常，缓存保持不变
+    std::unique_ptr<sql::PreparedStatement> stmt(conn->prepareStatement(sql));
+
+    if (lru_.size() >= capacity_)
+    {
+        index_.erase(std::string_view(lru_.back().sql));
+        lru_.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    lru_.push_front(Entry{ sql, std::move(stmt) });
+    index_.emplace(std::string_view(lru_.front().sql), lru_.begin());
+    size_.store(lru_.size(), std::memory_order_relaxed);
+    return lru_.front().stmt.get();
+}
+
+void StatementCache::evict(const std::string& sql)
+{
+    auto it = index_.find(std::string_view(sql));
+    if (it == index_.end())
+    {
+        return;
+    }
+    EntryList::iterator entry = it->second;
+    index_.erase(it);
+    lru_.erase(entry);
+    size_.store(lru_.size(), std::memory_order_relaxed);
+}
+
+void StatementCache::clear()
+{
+    index_.clear();
+    lru_.clear();
+    size_.store(0, std::memory_order_relaxed);
+}
+
+StatementCache::Stats StatementCache::stats() const
+{
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.size = size_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace db
+} // namespace http
@@ -19,19 +19,27 @@ class AiGame
 public:
     AiGame(int userId);
 
+    // 同一局棋可能被同一用户的多个请求同时访问（多个标签页、重复提交），
+    // 落子和读取状态都持有 mutex_；人类只能在轮到自己（已落子数为偶数）时落子，
+    // AI 的一步还没有算完时，另一个请求的落子会被拒绝
+
     // 判断是否平局
     bool isDraw() const
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        return moveCount_ >= BOARD_SIZE * BOARD_SIZE;
+        return isDrawLocked();
     }
 
     bool humanMove(int x, int y);
 
     bool checkWin(int x,int y, const std::string& player);
 
+    // 计算并落下 AI 的一步（耗时的搜索，在工作线程池中执行）
     void aiMove();
 
+    // AI 落子前的停顿（秒），由处理器用定时器等待，不占用线程
+    static constexpr double kAiMoveDelay = 0.5;
+
     // 获取最后一步移动的坐标
     std::pair<int, int> getLastMove() const 
     {
@@ -39,8 +47,8 @@ public:
         return lastMove_;
     }
 
-     // 获取当前棋盘状态
-    const std::vector<std::vector<std::string>>& getBoard() const 
+     // 获取当前棋盘状态（副本：返回之后棋盘仍可能被其他请求修改）
+    std::vector<std::vector<std::string>> getBoard() const 
     { 
         std::lock_guard<std::mutex> lock(mutex_);
         return board_; 
@@ -59,12 +67,18 @@ public:
     }
 
 private:
+    // 以下私有函数由调用方持有 mutex_
+    bool isDrawLocked() const
+    {
+        return moveCount_ >= BOARD_SIZE * BOARD_SIZE;
+    }
+
     // 检查移动是否有效
     bool isValidMove(int x, int y) const 
     {
         if (x < 0 || x >= BOARD_SIZE || y < 0 || y >= BOARD_SIZE) return false;
         if (board_[x][y] != EMPTY) return false;
-        if (gameOver_ || isDraw()) return false;
+        if (gameOver_ || isDrawLocked()) return false;
         return true;
     }
 
@@ -88,5 +102,5 @@ private:
     std::string                           winner_{"none"};
     std::pair<int, int>                   lastMove_{-1, -1};  // 上一次落子位置
     std::vector<std::vector<std::string>> board_;
-    mutable std::mutex                    mutex_;  // 添加互斥锁
+    mutable std::mutex                    mutex_;  // 保护以上所有状态
 };
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 #include "AiGame.h"
 #include "../../../HttpServer/include/http/HttpServer.h"
+#include "../../../HttpServer/include/http/StaticFileCache.h"
+#include "../../../HttpServer/include/http/StaticResource.h"
 #include "../../../HttpServer/include/utils/MysqlUtil.h"
 #include "../../../HttpServer/include/utils/FileUtil.h"
 #include "../../../HttpServer/include/utils/JsonUtil.h"
@@ -31,8 +33,10 @@ class GameBackendHandler;
 class GomokuServer
 {
 public:
+    // sessionFile 为持久化会话文件的路径，相对路径按启动时的工作目录解析
     GomokuServer(int port,
                  const std::string& name,
+                 const std::string& sessionFile,
                  bool useSSL = false,
                  muduo::net::TcpServer::Option option = muduo::net::TcpServer::kNoReusePort);
 
@@ -84,10 +88,10 @@ private:
     {
         std::string sql = "SELECT COUNT(*) as count FROM users";
 
-        sql::ResultSet* res = mysqlUtil_.executeQuery(sql);
-        if (res->next())
+        http::db::QueryResult res = mysqlUtil_.executeQuery(sql);
+        if (res.next())
         {
-            return res->getInt("count");
+            return res.get<int>("count");
         }
         return 0;
     }
@@ -121,4 +125,6 @@ private:
     std::mutex                                       mutexForOnlineUsers_; 
     // 最高在线人数
     std::atomic<int>                                 maxOnline_;
+    // 会话文件的绝对路径
+    std::string                                      sessionFile_;
 };
\ No newline at end of file
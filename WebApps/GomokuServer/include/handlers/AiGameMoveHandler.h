@@ -1,12 +1,12 @@
 #pragma once
-#include "../../../../HttpServer/include/router/RouterHandler.h"
+#include "../../../../HttpServer/include/router/AsyncRouterHandler.h"
 #include "../GomokuServer.h"
 
-class AiGameMoveHandler : public http::router::RouterHandler
+class AiGameMoveHandler : public http::router::AsyncRouterHandler
 {
 public:
     explicit AiGameMoveHandler(GomokuServer* server) : server_(server) {}
-    void handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
+    http::async::Task<> handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
 private:
     GomokuServer* server_;
 };
\ No newline at end of file
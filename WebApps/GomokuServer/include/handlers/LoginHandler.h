@@ -1,19 +1,19 @@
 #pragma once
-#include "../../../../HttpServer/include/router/RouterHandler.h"
+#include "../../../../HttpServer/include/router/AsyncRouterHandler.h"
 #include "../../../HttpServer/include/utils/MysqlUtil.h"
 #include "../GomokuServer.h"
 #include "../../../HttpServer/include/utils/JsonUtil.h"
 
 
-class LoginHandler : public http::router::RouterHandler 
+class LoginHandler : public http::router::AsyncRouterHandler 
 {
 public:
     explicit LoginHandler(GomokuServer* server) : server_(server) {}
     
-    void handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
+    http::async::Task<> handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
 
 private:
-    int queryUserId(const std::string& username, const std::string& password);
+    http::async::Task<int> queryUserId(const std::string& username, const std::string& password);
 
 private:
     GomokuServer*       server_;
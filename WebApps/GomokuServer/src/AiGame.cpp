@@ -1,7 +1,5 @@
 #include "AiGame.h"
 
-#include <chrono>
-#include <thread>
 
 
 AiGame::AiGame(int userId)
@@ -17,7 +15,9 @@ AiGame::AiGame(int userId)
 // 处理人类玩家移动
 bool AiGame::humanMove(int x, int y) 
 {
-    if (!isValidMove(x, y)) 
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 人类执黑先行，轮到 AI 时（上一步还没有算完）不能落子
+    if (moveCount_ % 2 != 0 || !isValidMove(x, y)) 
         return false;
     
     board_[x][y] = HUMAN_PLAYER;
@@ -35,9 +35,9 @@ bool AiGame::humanMove(int x, int y)
  // AI移动
 void AiGame::aiMove() 
 {
-    if (gameOver_ || isDraw()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (gameOver_ || isDrawLocked() || moveCount_ % 2 == 0) return;
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 添加500毫秒延时
     int x, y;
     // 获取AI的最佳移动位置
     std::tie(x, y) = getBestMove();
@@ -1,3 +1,6 @@
+#include <climits>
+#include <unistd.h>
+
 #include "../include/handlers/EntryHandler.h"
 #include "../include/handlers/LoginHandler.h"
 #include "../include/handlers/RegisterHandler.h"
@@ -15,10 +18,20 @@ using namespace http;
 
 GomokuServer::GomokuServer(int port,
                            const std::string &name,
+                           const std::string &sessionFile,
                            bool useSSL,
                            muduo::net::TcpServer::Option option)
-    : httpServer_(port, name, useSSL, option), maxOnline_(0)
+    : httpServer_(port, name, useSSL, option), maxOnline_(0), sessionFile_(sessionFile)
 {
+    // 相对路径在这里换成绝对路径，之后工作目录变化也不会打开另一个文件
+    if (!sessionFile_.empty() && sessionFile_[0] != '/')
+    {
+        char cwd[PATH_MAX];
+        if (::getcwd(cwd, sizeof cwd) != nullptr)
+        {
+            sessionFile_ = std::string(cwd) + "/" + sessionFile_;
+        }
+    }
     initialize();
 }
 
@@ -47,12 +60,16 @@ void GomokuServer::initialize()
     initializeMiddleware();
     // 初始化路由
     initializeRouter();
+    // 静态页面缓存：资源目录下的文件变化时自动失效
+    http::StaticFileCache::getInstance().setMemoryLimit(16 * 1024 * 1024);
+    http::StaticFileCache::getInstance().watch("../WebApps/GomokuServer/resource");
 }
 
 void GomokuServer::initializeSession()
 {
-    // 创建会话存储
-    auto sessionStorage = std::make_unique<http::session::MemorySessionStorage>();
+    // 创建会话存储：会话保存在内存映射的文件中，发布新版本重启后玩家不需要重新登录
+    LOG_INFO << "Session file: " << sessionFile_;
+    auto sessionStorage = std::make_unique<http::session::MmapSessionStorage>(sessionFile_);
     // 创建会话管理器
     auto sessionManager = std::make_unique<http::session::SessionManager>(std::move(sessionStorage));
     // 设置会话管理器
@@ -65,59 +82,61 @@ void GomokuServer::initializeMiddleware()
     auto corsMiddleware = std::make_shared<http::middleware::CorsMiddleware>();
     // 添加中间件
     httpServer_.addMiddleware(corsMiddleware);
+    // 鉴权中间件：每个请求解析一次会话，处理器通过 req.auth() 取得当前用户
+    httpServer_.addMiddleware(std::make_shared<http::middleware::AuthMiddleware>(getSessionManager()));
+    // 开启响应压缩，静态页面使用缓存中的预压缩版本
+    httpServer_.enableCompression();
 }
 
 void GomokuServer::initializeRouter()
 {
-    // 注册url回调处理器
-    // 登录注册入口页面
-    httpServer_.Get("/", std::make_shared<EntryHandler>(this));
-    httpServer_.Get("/entry", std::make_shared<EntryHandler>(this));
+    // 固定的同步页面路由放在编译期静态路由表中：完美哈希定位，处理器按具体类型直接调用
+    // 页面允许浏览器缓存，但每次使用前都要用 ETag 重新验证（未修改时返回 304）；菜单页面按用户渲染、
+    // 开始对战页面每次都重置对局，这两个不缓存
+    // requireAuth() 的路由未登录时直接返回 401，处理器中不再检查登录状态
+    httpServer_.setStaticRouter(http::router::makeStaticRouter(
+        // 登录注册入口页面
+        http::router::get<"/">(EntryHandler(this)).cacheControl("no-cache"),
+        http::router::get<"/entry">(EntryHandler(this)).cacheControl("no-cache"),
+        // 登出
+        http::router::post<"/user/logout">(LogoutHandler(this)).requireAuth(),
+        // 菜单页面
+        http::router::get<"/menu">(MenuHandler(this)).cacheControl("no-store").requireAuth(),
+        // 开始对战ai
+        http::router::get<"/aiBot/start">(AiGameStartHandler(this)).cacheControl("no-store").requireAuth(),
+        // 重新开始对战ai
+        http::router::get<"/aiBot/restart">(
+        [this](const http::HttpRequest& req, http::HttpResponse* resp) {
+            restartChessGameVsAi(req, resp);
+        }).requireAuth(),
+        // 后台界面
+        http::router::get<"/backend">(GameBackendHandler(this)).cacheControl("no-cache").requireAuth()));
+
+    // 协程式、阻塞的路由注册到动态路由
     // 登录
     httpServer_.Post("/login", std::make_shared<LoginHandler>(this));
     // 注册
     httpServer_.Post("/register", std::make_shared<RegisterHandler>(this));
-    // 登出
-    httpServer_.Post("/user/logout", std::make_shared<LogoutHandler>(this));
-    // 菜单页面
-    httpServer_.Get("/menu", std::make_shared<MenuHandler>(this));
-    // 开始对战ai
-    httpServer_.Get("/aiBot/start", std::make_shared<AiGameStartHandler>(this));
     // 下棋
     httpServer_.Post("/aiBot/move", std::make_shared<AiGameMoveHandler>(this));
-    // 重新开始对战ai
-    httpServer_.Get("/aiBot/restart", 
-    [this](const http::HttpRequest& req, http::HttpResponse* resp) {
-            restartChessGameVsAi(req, resp);
-    });
-
-    // 后台界面
-    httpServer_.Get("/backend", std::make_shared<GameBackendHandler>(this));
+    httpServer_.setAuthRequired(http::HttpRequest::kPost, "/aiBot/move");
     // 后台数据获取
     httpServer_.Get("/backend_data", [this](const http::HttpRequest& req, http::HttpResponse* resp) {
         getBackendData(req, resp);
     });
+    httpServer_.setAuthRequired(http::HttpRequest::kGet, "/backend_data");
+
+    // 访问数据库的同步路由在工作线程池中执行，不阻塞 IO 线程；
+    // 登录和下棋是协程式处理器，只把查询和 AI 搜索交给工作线程池
+    httpServer_.setWorkerThreads(4);
+    httpServer_.setBlocking(http::HttpRequest::kPost, "/register");
+    httpServer_.setBlocking(http::HttpRequest::kGet, "/backend_data");
 }
 
 void GomokuServer::restartChessGameVsAi(const http::HttpRequest &req, http::HttpResponse *resp)
 {
-    // 解析请求体
-    auto session = getSessionManager()->getSession(req, resp);
-    if (session->getValue("isLoggedIn") != "true")
-    {
-        // 用户未登录，返回未授权错误
-        json errorResp;
-        errorResp["status"] = "error";
-        errorResp["message"] = "Unauthorized";
-        std::string errorBody = errorResp.dump(4);
-
-        packageResp(req.getVersion(), http::HttpResponse::k401Unauthorized,
-                    "Unauthorized", true, "application/json", errorBody.size(),
-                    errorBody, resp);
-        return;
-    }
-
-    int userId = std::stoi(session->getValue("userId"));
+    // 路由要求登录，鉴权中间件已解析出用户 id
+    int userId = req.auth().userId;
     {
         // 重新开始ai对战
         std::lock_guard<std::mutex> lock(mutexForAiGames_);
@@ -157,6 +176,31 @@ void GomokuServer::getBackendData(const http::HttpRequest &req, http::HttpRespon
             {"totalUser", totalUser}
         };
 
+        // 会话存储的运行指标
+        auto* storage = dynamic_cast<http::session::MmapSessionStorage*>(getSessionManager()->storage());
+        if (storage)
+        {
+            http::session::MmapSessionStorage::Stats stats = storage->stats();
+            respBody["sessions"] = {
+                {"count", stats.sessions},
+                {"loaded", stats.loaded},
+                {"unpersisted", stats.unpersisted},
+                {"slots", stats.slots},
+                {"freeSlots", stats.freeSlots},
+                {"overflowRecords", stats.overflowRecords}
+            };
+        }
+
+        // 数据库预处理语句缓存
+        http::db::StatementCache::Stats stmtStats = http::MysqlUtil::statementStats();
+        respBody["statementCache"] = {
+            {"hits", stmtStats.hits},
+            {"misses", stmtStats.misses},
+            {"evictions", stmtStats.evictions},
+            {"size", stmtStats.size},
+            {"hitRate", stmtStats.hitRate()}
+        };
+
         // 转换为字符串
         std::string responseStr = respBody.dump(4);
         
@@ -1,37 +1,28 @@
 #include "../include/handlers/AiGameMoveHandler.h"
 
-void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
+http::async::Task<> AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
 {
     try
     {
-        auto session = server_->getSessionManager()->getSession(req, resp);
-        if (session->getValue("isLoggedIn") != "true")
-        {
-            // 用户未登录，返回未授权错误
-            json errorResp;
-            errorResp["status"] = "error";
-            errorResp["message"] = "Unauthorized";
-            std::string errorBody = errorResp.dump(4);
-
-            server_->packageResp(req.getVersion(), http::HttpResponse::k401Unauthorized,
-                                 "Unauthorized", true, "application/json", errorBody.size(),
-                                 errorBody, resp);
-            return;
-        }
-
-        int userId = std::stoi(session->getValue("userId"));
+        // 路由要求登录，鉴权中间件已解析出用户 id
+        int userId = req.auth().userId;
         // 解析请求体
-        json request = json::parse(req.getBody());
+        json request = json::parse(req.body());
         int x = request["x"];
         int y = request["y"];
 
-        // 获取或创建游戏实例
-        if (server_->aiGames_.find(userId) == server_->aiGames_.end())
+        // 获取或创建游戏实例。持有一份 shared_ptr：协程挂起期间 aiGames_ 中的条目可能被重新开始的对局替换；
+        // 对同一局棋的并发访问由 AiGame 自己的锁串行化
+        std::shared_ptr<AiGame> game;
         {
             std::lock_guard<std::mutex> lock(server_->mutexForAiGames_);
-            server_->aiGames_[userId] = std::make_shared<AiGame>(userId);
+            std::shared_ptr<AiGame>& entry = server_->aiGames_[userId];
+            if (!entry)
+            {
+                entry = std::make_shared<AiGame>(userId);
+            }
+            game = entry;
         }
-        auto &game = server_->aiGames_[userId];
 
         // 处理人类玩家移动
         if (!game->humanMove(x, y))
@@ -46,7 +37,7 @@ void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse
             resp->setContentType("application/json");
             resp->setContentLength(responseBody.size());
             resp->setBody(responseBody);
-            return;
+            co_return;
         }
 
         // 检查人类玩家是否获胜
@@ -67,9 +58,14 @@ void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse
 
             {
                 std::lock_guard<std::mutex> lock(server_->mutexForAiGames_);
-                server_->aiGames_.erase(userId); // 这里删掉以后，每次restart都需要重新创建就行
+                // 这里删掉以后，每次restart都需要重新创建就行；条目已被新开的对局替换时不删
+                auto it = server_->aiGames_.find(userId);
+                if (it != server_->aiGames_.end() && it->second == game)
+                {
+                    server_->aiGames_.erase(it);
+                }
             }
-            return;
+            co_return;
         }
 
         // 检查是否平局（在AI移动之前）
@@ -90,13 +86,19 @@ void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse
 
             {
                 std::lock_guard<std::mutex> lock(server_->mutexForAiGames_);
-                server_->aiGames_.erase(userId); // 这里删掉以后，每次restart都需要重新创建就行
+                // 这里删掉以后，每次restart都需要重新创建就行；条目已被新开的对局替换时不删
+                auto it = server_->aiGames_.find(userId);
+                if (it != server_->aiGames_.end() && it->second == game)
+                {
+                    server_->aiGames_.erase(it);
+                }
             }
-            return;
+            co_return;
         }
 
-        // AI移动
-        game->aiMove();
+        // AI移动：先用定时器停顿，再把搜索交给工作线程池，等待期间 IO 线程继续处理其他连接
+        co_await http::async::sleepFor(AiGame::kAiMoveDelay);
+        co_await http::async::runInPool(server_->httpServer_.workerPool(), [game]() { game->aiMove(); });
 
         // 检查AI是否获胜
         if (game->isGameOver())
@@ -117,9 +119,14 @@ void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse
 
             {
                 std::lock_guard<std::mutex> lock(server_->mutexForAiGames_);
-                server_->aiGames_.erase(userId); // 这里删掉以后，每次restart都需要重新创建就行
+                // 这里删掉以后，每次restart都需要重新创建就行；条目已被新开的对局替换时不删
+                auto it = server_->aiGames_.find(userId);
+                if (it != server_->aiGames_.end() && it->second == game)
+                {
+                    server_->aiGames_.erase(it);
+                }
             }
-            return;
+            co_return;
         }
 
         // 再次检查是否平局（在AI移动之后）
@@ -141,9 +148,14 @@ void AiGameMoveHandler::handle(const http::HttpRequest &req, http::HttpResponse
 
             {
                 std::lock_guard<std::mutex> lock(server_->mutexForAiGames_);
-                server_->aiGames_.erase(userId); // 这里删掉以后，每次restart都需要重新创建就行
+                // 这里删掉以后，每次restart都需要重新创建就行；条目已被新开的对局替换时不删
+                auto it = server_->aiGames_.find(userId);
+                if (it != server_->aiGames_.end() && it->second == game)
+                {
+                    server_->aiGames_.erase(it);
+                }
             }
-            return;
+            co_return;
         }
 
         // 游戏继续
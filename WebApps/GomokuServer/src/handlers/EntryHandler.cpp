@@ -5,20 +5,13 @@ void EntryHandler::handle(const http::HttpRequest& req, http::HttpResponse* resp
     // 因为是get请求，请求的url也拿到了，我们就可以直接返回响应了
     std::string reqFile;
     reqFile.append("../WebApps/GomokuServer/resource/entry.html");
-    FileUtil fileOperater(reqFile);
-    if (!fileOperater.isValid())
+    resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
+    resp->setCloseConnection(false);
+    // 入口页面从静态文件缓存中取，不再每次读盘；浏览器带着 ETag 重新验证时返回 304
+    if (!http::StaticFileCache::getInstance().serve(req, reqFile, resp))
     {
         LOG_WARN << reqFile << " not exist";
-        fileOperater.resetDefaultFile(); // 404 NOT FOUND
+        resp->setContentType("text/html");
+        resp->setFile("../WebApps/GomokuServer/resource/NotFound.html");
     }
-
-    std::vector<char> buffer(fileOperater.size());
-    fileOperater.readFile(buffer); // 读出文件数据
-    std::string bufStr = std::string(buffer.data(), buffer.size());
-    
-    resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
-    resp->setCloseConnection(false);
-    resp->setContentType("text/html");
-    resp->setContentLength(bufStr.size());
-    resp->setBody(bufStr);
 }
@@ -1,11 +1,11 @@
 #include "../include/handlers/LoginHandler.h"
 
-void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
+http::async::Task<> LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
 {
     // 处理登录逻辑
     // 验证 contentType
-    auto contentType = req.getHeader("Content-Type");
-    if (contentType.empty() || contentType != "application/json" || req.getBody().empty())
+    auto contentType = req.header("Content-Type");
+    if (contentType.empty() || contentType != "application/json" || req.body().empty())
     {
         LOG_INFO << "content" << req.getBody();
         resp->setStatusLine(req.getVersion(), http::HttpResponse::k400BadRequest, "Bad Request");
@@ -13,17 +13,17 @@ void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp
         resp->setContentType("application/json");
         resp->setContentLength(0);
         resp->setBody("");
-        return;
+        co_return;
     }
 
     // JSON 解析使用 try catch 捕获异常
     try
     {
-        json parsed = json::parse(req.getBody());
+        json parsed = json::parse(req.body());
         std::string username = parsed["username"];
         std::string password = parsed["password"];
-        // 验证用户是否存在
-        int userId = queryUserId(username, password);
+        // 验证用户是否存在：查询在工作线程池中执行，协程回到 IO 线程后继续
+        int userId = co_await queryUserId(username, password);
         if (userId != -1)
         {
             // 获取会话
@@ -57,7 +57,7 @@ void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp
                 resp->setContentType("application/json");
                 resp->setContentLength(successBody.size());
                 resp->setBody(successBody);
-                return;
+                co_return;
             }
             else
             {
@@ -73,7 +73,7 @@ void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp
                 resp->setContentType("application/json");
                 resp->setContentLength(failureBody.size());
                 resp->setBody(failureBody);
-                return;
+                co_return;
             }
         }
         else // 账号密码错误，请重新登录
@@ -89,7 +89,7 @@ void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp
             resp->setContentType("application/json");
             resp->setContentLength(failureBody.size());
             resp->setBody(failureBody);
-            return;
+            co_return;
         }
     }
     catch (const std::exception &e)
@@ -105,23 +105,22 @@ void LoginHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp
         resp->setContentType("application/json");
         resp->setContentLength(failureBody.size());
         resp->setBody(failureBody);
-        return;
+        co_return;
     }
 }
 
-int LoginHandler::queryUserId(const std::string &username, const std::string &password)
+http::async::Task<int> LoginHandler::queryUserId(const std::string &username, const std::string &password)
 {
     // 前端用户传来账号密码，查找数据库是否有该账号密码
     // 使用预处理语句, 防止sql注入
     std::string sql = "SELECT id FROM users WHERE username = ? AND password = ?";
     // std::vector<std::string> params = {username, password};
-    sql::ResultSet* res = mysqlUtil_.executeQuery(sql, username, password);
-    if (res->next())
+    http::db::QueryResult res = co_await mysqlUtil_.executeQueryAsync(server_->httpServer_.workerPool(), sql, username, password);
+    if (res.next())
     {
-        int id = res->getInt("id");
-        return id;
+        co_return res.get<int>("id");
     }
     // 如果查询结果为空，则返回-1
-    return -1;
+    co_return -1;
 }
 
@@ -2,8 +2,8 @@
 
 void LogoutHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
 {
-    auto contentType = req.getHeader("Content-Type");
-    if (contentType.empty() || contentType != "application/json" || req.getBody().empty())
+    auto contentType = req.header("Content-Type");
+    if (contentType.empty() || contentType != "application/json" || req.body().empty())
     {
         resp->setStatusLine(req.getVersion(), http::HttpResponse::k400BadRequest, "Bad Request");
         resp->setCloseConnection(true);
@@ -16,16 +16,13 @@ void LogoutHandler::handle(const http::HttpRequest &req, http::HttpResponse *res
     // JSON 解析使用 try catch 捕获异常
     try
     {
-        // 获取会话
+        // 用户 id 由鉴权中间件解析；会话已绑定在请求上，这里不会重复加载
+        int userId = req.auth().userId;
         auto session = server_->getSessionManager()->getSession(req, resp);
-        // 获取用户id
-        int userId = std::stoi(session->getValue("userId"));
-        // 清除会话数据
-        session->clear();
-        // 销毁会话
-        server_->getSessionManager()->destroySession(session->getId());
+        // 销毁会话（请求结束时不再保存，并让浏览器删除会话 Cookie）
+        server_->getSessionManager()->destroySession(*session);
         
-        json parsed = json::parse(req.getBody());
+        json parsed = json::parse(req.body());
         int gameType = parsed["gameType"]; // fixme: 以后也换成从会话中获取
         
         {   // 释放资源
@@ -5,45 +5,19 @@ void MenuHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
     // JSON 解析使用 try catch 捕获异常
     try
     {
-        // 检查用户是否已登录
-        auto session = server_->getSessionManager()->getSession(req, resp);
-        LOG_INFO << "session->getValue(\"isLoggedIn\") = " << session->getValue("isLoggedIn");
-        if (session->getValue("isLoggedIn") != "true")
-        {
-            // 用户未登录，返回未授权错误
-            json errorResp;
-            errorResp["status"] = "error";
-            errorResp["message"] = "Unauthorized";
-            std::string errorBody = errorResp.dump(4);
-
-            server_->packageResp(req.getVersion(), http::HttpResponse::k401Unauthorized,
-                                "Unauthorized", true, "application/json", errorBody.size(),
-                                 errorBody, resp);
-            return;
-        }
-
-        // 获取用户信息
-        int userId = std::stoi(session->getValue("userId"));
-        std::string username = session->getValue("username");
+        // 路由要求登录，用户信息由鉴权中间件解析
+        int userId = req.auth().userId;
 
         std::string reqFile("../WebApps/GomokuServer/resource/menu.html");
-        FileUtil fileOperater(reqFile);
-        if (!fileOperater.isValid())
+        http::StaticFileCache::EntryPtr page = http::StaticFileCache::getInstance().get(reqFile);
+        if (!page)
         {
             LOG_WARN << reqFile << "not exist.";
-            fileOperater.resetDefaultFile();
-        }
-
-        std::vector<char> buffer(fileOperater.size());
-        fileOperater.readFile(buffer); // 读出文件数据
-        std::string htmlContent(buffer.data(), buffer.size());
-
-        // 在HTML内容中插入userId
-        size_t headEnd = htmlContent.find("</head>");
-        if (headEnd != std::string::npos)
-        {
-            std::string script = "<script>const userId = '" + std::to_string(userId) + "';</script>";
-            htmlContent.insert(headEnd, script);
+            page = http::StaticFileCache::getInstance().get("../WebApps/GomokuServer/resource/NotFound.html");
+            if (!page)
+            {
+                throw std::runtime_error("menu page not found");
+            }
         }
 
         // server_->packageResp(req.getVersion(), HttpResponse::k200Ok, "OK"
@@ -51,8 +25,16 @@ void MenuHandler::handle(const http::HttpRequest &req, http::HttpResponse *resp)
         resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
         resp->setCloseConnection(false);
         resp->setContentType("text/html");
-        resp->setContentLength(htmlContent.size());
-        resp->setBody(htmlContent);
+        // menu.html 中的 {{userId}} 占位符在加载时已经预编译，这里只填入当前用户的值，
+        // 页面的静态部分直接引用缓存
+        if (page->htmlTemplate)
+        {
+            page->htmlTemplate->render({ { "userId", std::to_string(userId) } }, resp);
+        }
+        else
+        {
+            resp->setBody(page->content);
+        }
     }
     catch (const std::exception &e)
     {
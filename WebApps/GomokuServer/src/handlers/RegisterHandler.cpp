@@ -3,7 +3,7 @@
 void RegisterHandler::handle(const http::HttpRequest& req, http::HttpResponse* resp)
 {
     // 解析body(json格式)
-    json parsed = json::parse(req.getBody());
+    json parsed = json::parse(req.body());
     std::string username = parsed["username"];
     std::string password = parsed["password"];
 
@@ -47,13 +47,14 @@ int RegisterHandler::insertUser(const std::string &username, const std::string &
     if (!isUserExist(username))
     {
         // 用户不存在，插入用户
-        std::string sql = "INSERT INTO users (username, password) VALUES ('" + username + "', '" + password + "')";
-        mysqlUtil_.executeUpdate(sql);
-        std::string sql2 = "SELECT id FROM users WHERE username = '" + username + "'";
-        sql::ResultSet* res = mysqlUtil_.executeQuery(sql2);
-        if (res->next())
+        // 使用占位符：SQL 文本固定，预处理语句可以被缓存复用，也避免 sql 注入
+        std::string sql = "INSERT INTO users (username, password) VALUES (?, ?)";
+        mysqlUtil_.executeUpdate(sql, username, password);
+        std::string sql2 = "SELECT id FROM users WHERE username = ?";
+        http::db::QueryResult res = mysqlUtil_.executeQuery(sql2, username);
+        if (res.next())
         {
-            return res->getInt("id");
+            return res.get<int>("id");
         }
     }
     return -1;
@@ -61,11 +62,7 @@ int RegisterHandler::insertUser(const std::string &username, const std::string &
 
 bool RegisterHandler::isUserExist(const std::string &username)
 {
-    std::string sql = "SELECT id FROM users WHERE username = '" + username + "'";
-    sql::ResultSet* res = mysqlUtil_.executeQuery(sql);
-    if (res->next())
-    {
-        return true;
-    }
-    return false;
+    std::string sql = "SELECT id FROM users WHERE username = ?";
+    // 只关心是否有行，结果在返回时释放并归还连接
+    return mysqlUtil_.executeQuery(sql, username).next();
 }
\ No newline at end of file
@@ -12,10 +12,12 @@ int main(int argc, char* argv[])
   
   std::string serverName = "HttpServer";
   int port = 8080;
+  // 会话文件，滚动发布时新旧进程要用同一个路径
+  std::string sessionFile = "gomoku_sessions.dat";
   
   // 参数解析
   int opt;
-  const char* str = "p:";
+  const char* str = "p:s:";
   while ((opt = getopt(argc, argv, str)) != -1)
   {
     switch (opt)
@@ -25,13 +27,18 @@ int main(int argc, char* argv[])
         port = atoi(optarg);
         break;
       }
+      case 's':
+      {
+        sessionFile = optarg;
+        break;
+      }
       default:
         break;
     }
   }
   bool useSSL = true;
   muduo::Logger::setLogLevel(muduo::Logger::WARN);
-  GomokuServer server(port, serverName, useSSL);
+  GomokuServer server(port, serverName, sessionFile, useSSL);
 
   if (useSSL)
   {